@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "../src/cache_hierarchy.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+// Walks a range(0)-byte buffer with a stride of 72 bytes, forever
+const char* const kWalkProgram =
+    "    LI R7, 0x100000\n"
+    "restart:\n"
+    "    LI R1, 0x100000\n"
+    "loop:\n"
+    "    LOAD R2, 0(R1)\n"
+    "    ADD R3, R3, R2\n"
+    "    ADDI R1, R1, 72\n"
+    "    CMP R1, R6\n"
+    "    BLTU loop\n"
+    "    JMP restart\n";
+
+void setCounters(benchmark::State& state, uint64_t steps) {
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(steps));
+    state.counters["MIPS"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(steps) / 1e6,
+        benchmark::Counter::kIsRate);
+}
+
+ProcessorSimulator& walker(ProcessorSimulator& simulator, int64_t bytes) {
+    simulator.loadProgram(kWalkProgram);
+    simulator.getState().writeRegister(6, 0x100000 + static_cast<uint64_t>(bytes));
+    return simulator;
+}
+
+// Lookups alone, over a working set of range(0) bytes
+void BM_CacheAccess(benchmark::State& state) {
+    CacheHierarchy caches;
+    uint64_t mask = static_cast<uint64_t>(state.range(0)) - 1;
+    uint64_t address = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(caches.access(address & mask, false));
+        address += 0x9E37;  // Odd stride: touches every line
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// Every instruction through the cache model
+void BM_RunDetailed(benchmark::State& state) {
+    constexpr uint64_t kSteps = 1 << 20;
+    CacheHierarchy caches;
+    ProcessorSimulator simulator;
+    walker(simulator, state.range(0)).setCacheModel(&caches);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simulator.run(kSteps));
+    }
+    setCounters(state, kSteps);
+}
+
+// The same run sampled: 1% of the instructions in detailed windows
+void BM_RunSampled(benchmark::State& state) {
+    constexpr uint64_t kSteps = 1 << 20;
+    CacheHierarchy caches;
+    ProcessorSimulator simulator;
+    walker(simulator, state.range(0));
+    SamplingPlan plan;
+    plan.fastForward = 98000;
+    plan.warmup = 1000;
+    plan.window = 1000;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simulator.runSampled(caches, plan, kSteps));
+    }
+    setCounters(state, kSteps);
+}
+
+} // namespace
+
+BENCHMARK(BM_CacheAccess)->Arg(16 << 10)->Arg(64 << 20);
+BENCHMARK(BM_RunDetailed)->Arg(4 << 20);
+BENCHMARK(BM_RunSampled)->Arg(4 << 20);
@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+#include "../src/checkpoint.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+// Bumps one word per iteration, walking through memory from 0x100000
+const char* const kForkProgram =
+    "    LI R1, 0x100000\n"
+    "loop:\n"
+    "    LOAD R2, 0(R1)\n"
+    "    ADDI R2, R2, 1\n"
+    "    STORE R2, 0(R1)\n"
+    "    ADDI R1, R1, 8\n"
+    "    JMP loop\n";
+
+constexpr uint64_t kStepsPerFork = 1000;
+
+// Fork from a prefix that touched range(0) pages, run briefly and rewind.
+// The cost should not grow with the size of the prefix's memory.
+void BM_CheckpointFork(benchmark::State& state) {
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kForkProgram);
+    for (uint64_t page = 0; page < static_cast<uint64_t>(state.range(0)); ++page) {
+        simulator.getMemory().store64(0x100000 + page * SimulatedMemory::kPageBytes, page);
+    }
+    Checkpoint checkpoint = simulator.checkpoint();
+
+    for (auto _ : state) {
+        simulator.restore(checkpoint);
+        benchmark::DoNotOptimize(simulator.run(kStepsPerFork));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    state.SetLabel(std::to_string(state.range(0) * 4) + " KiB prefix");
+}
+
+} // namespace
+
+BENCHMARK(BM_CheckpointFork)->Arg(16)->Arg(1024)->Arg(16384);
@@ -0,0 +1,211 @@
+#include <benchmark/benchmark.h>
+#include <bitset>
+#include <random>
+#include <sstream>
+#include <string>
+#include "../src/conversion_engine.hpp"
+#include "../src/fixed_width_conversion.hpp"
+#include "../src/packed_bits.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+// The original substr/bitset/stringstream STANDARD conversion, kept as the baseline
+std::string legacyBinaryToHex(const std::string& binaryStr) {
+    std::string paddedBinary = binaryStr;
+    while (paddedBinary.length() % 4 != 0) {
+        paddedBinary = '0' + paddedBinary;
+    }
+
+    std::stringstream hexStream;
+    hexStream << std::hex << std::uppercase;
+    for (size_t i = 0; i < paddedBinary.length(); i += 4) {
+        std::string chunk = paddedBinary.substr(i, 4);
+        unsigned long decimal = std::bitset<4>(chunk).to_ulong();
+        hexStream << decimal;
+    }
+    return hexStream.str();
+}
+
+std::string makeBinaryInput(size_t length) {
+    std::mt19937_64 rng(length);
+    std::string binary(length, '0');
+    uint64_t random = 0;
+    for (size_t i = 0; i < length; ++i) {
+        if (i % 64 == 0) {
+            random = rng();
+        }
+        binary[i] = static_cast<char>('0' + (random >> (i % 64) & 1));
+    }
+    return binary;
+}
+
+const char* modeName(ConversionMode mode) {
+    switch (mode) {
+        case ConversionMode::STANDARD: return "STANDARD";
+        case ConversionMode::SIGNED: return "SIGNED";
+        case ConversionMode::UNSIGNED: return "UNSIGNED";
+        case ConversionMode::FLOATING_POINT: return "FLOATING_POINT";
+    }
+    return "";
+}
+
+void BM_LegacyBinaryToHex(benchmark::State& state) {
+    std::string input = makeBinaryInput(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyBinaryToHex(input));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+void BM_EngineBinaryToHex(benchmark::State& state) {
+    auto isa = static_cast<ConversionEngine::Isa>(state.range(1));
+    if (static_cast<int>(isa) > static_cast<int>(ConversionEngine::detectIsa())) {
+        state.SkipWithError("instruction set not supported on this CPU");
+        return;
+    }
+    ConversionEngine::Isa previous = ConversionEngine::activeIsa();
+    ConversionEngine::setActiveIsa(isa);
+    state.SetLabel(ConversionEngine::isaName(isa));
+
+    std::string input = makeBinaryInput(static_cast<size_t>(state.range(0)));
+    std::string output(ConversionEngine::hexLength(input.length()), '\0');
+    for (auto _ : state) {
+        ConversionEngine::binaryToHex(input.data(), input.length(), &output[0]);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    ConversionEngine::setActiveIsa(previous);
+}
+
+void BM_SimulatorBinaryToHex(benchmark::State& state) {
+    std::string input = makeBinaryInput(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ProcessorSimulator::binaryToHex(input));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// Every mode through the public entry point. FLOATING_POINT accepts at most
+// 64 bits, so its larger sizes are skipped.
+void BM_BinaryToHexMode(benchmark::State& state) {
+    auto mode = static_cast<ConversionMode>(state.range(1));
+    if (mode == ConversionMode::FLOATING_POINT && state.range(0) > 64) {
+        state.SkipWithError("floating-point input is at most 64 bits");
+        return;
+    }
+    state.SetLabel(modeName(mode));
+    std::string input = makeBinaryInput(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ProcessorSimulator::binaryToHex(input, mode));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// The allocation-free overload into a reused buffer
+void BM_BinaryToHexIntoBuffer(benchmark::State& state) {
+    auto mode = static_cast<ConversionMode>(state.range(1));
+    state.SetLabel(modeName(mode));
+    std::string input = makeBinaryInput(static_cast<size_t>(state.range(0)));
+    std::string output(ProcessorSimulator::maxHexLength(input.size(), mode), '\0');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ProcessorSimulator::binaryToHex(input, mode, &output[0], output.size()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// multiThreadedBinaryToHex from 4 bits to 1 GiB by thread count (0 = whole pool)
+void BM_MultiThreadedBinaryToHex(benchmark::State& state) {
+    auto threads = static_cast<unsigned>(state.range(1));
+    ProcessorSimulator simulator;
+    simulator.setParallelism(threads);
+    state.SetLabel(threads == 0 ? "pool" : std::to_string(threads) + " threads");
+
+    std::string input = makeBinaryInput(static_cast<size_t>(state.range(0)));
+    std::string output(ConversionEngine::hexLength(input.length()), '\0');
+    for (auto _ : state) {
+        simulator.multiThreadedBinaryToHex(input, &output[0]);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// Register-width inputs through the runtime entry point
+void BM_SimulatorRegisterWidth(benchmark::State& state) {
+    auto mode = static_cast<ConversionMode>(state.range(1));
+    std::string input = makeBinaryInput(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ProcessorSimulator::binaryToHex(input, mode));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// The 64-bit kernel called directly, as code that knows the width at compile time does
+void BM_FixedWidthKernel64(benchmark::State& state) {
+    using Kernel = FixedWidthConverter<ConversionMode::UNSIGNED, 64>;
+    std::string input = makeBinaryInput(64);
+    char out[Kernel::kMaxOutputLength];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Kernel::convert(input.data(), out));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// Packed input straight to hex, no ASCII expansion
+void BM_PackedToHex(benchmark::State& state) {
+    PackedBits packed = PackedBits::fromAscii(makeBinaryInput(static_cast<size_t>(state.range(0))));
+    std::string output(ConversionEngine::hexLength(packed.size()), '\0');
+    for (auto _ : state) {
+        PackedBits::toHex(packed.data(), packed.size(), &output[0]);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0) / 8);
+}
+
+void BM_EngineHexToBinary(benchmark::State& state) {
+    std::string binary = makeBinaryInput(static_cast<size_t>(state.range(0)));
+    std::string hex(ConversionEngine::hexLength(binary.length()), '\0');
+    ConversionEngine::binaryToHex(binary.data(), binary.length(), &hex[0]);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ConversionEngine::hexToBinary(hex.data(), hex.length(), &binary[0]));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_LegacyBinaryToHex)->RangeMultiplier(16)->Range(64, 4 << 20);
+BENCHMARK(BM_EngineBinaryToHex)
+    ->ArgsProduct({benchmark::CreateRange(64, 4 << 20, 16),
+                   {static_cast<int64_t>(ConversionEngine::Isa::SCALAR),
+                    static_cast<int64_t>(ConversionEngine::Isa::SSE2),
+                    static_cast<int64_t>(ConversionEngine::Isa::AVX2)}});
+BENCHMARK(BM_SimulatorBinaryToHex)->RangeMultiplier(16)->Range(64, 4 << 20);
+BENCHMARK(BM_BinaryToHexMode)
+    ->ArgsProduct({{4, 8, 16, 32, 64, 4096, 1 << 20},
+                   {static_cast<int64_t>(ConversionMode::STANDARD),
+                    static_cast<int64_t>(ConversionMode::SIGNED),
+                    static_cast<int64_t>(ConversionMode::UNSIGNED),
+                    static_cast<int64_t>(ConversionMode::FLOATING_POINT)}});
+BENCHMARK(BM_BinaryToHexIntoBuffer)
+    ->ArgsProduct({{64, 100, 4096},
+                   {static_cast<int64_t>(ConversionMode::STANDARD),
+                    static_cast<int64_t>(ConversionMode::SIGNED)}});
+BENCHMARK(BM_MultiThreadedBinaryToHex)
+    ->ArgsProduct({benchmark::CreateRange(4, 1 << 30, 16), {1, 2, 4, 8, 0}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SimulatorRegisterWidth)
+    ->ArgsProduct({{8, 16, 32, 64},
+                   {static_cast<int64_t>(ConversionMode::STANDARD),
+                    static_cast<int64_t>(ConversionMode::SIGNED),
+                    static_cast<int64_t>(ConversionMode::FLOATING_POINT)}});
+BENCHMARK(BM_FixedWidthKernel64);
+BENCHMARK(BM_PackedToHex)->RangeMultiplier(16)->Range(64, 4 << 20);
+BENCHMARK(BM_EngineHexToBinary)->RangeMultiplier(16)->Range(64, 4 << 20);
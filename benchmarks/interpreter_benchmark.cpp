@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include "../src/execution_trace.hpp"
+#include "../src/interpreter.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+// A tight loop: 4 instructions per iteration, one load/store pair every pass
+const char* const kLoopProgram =
+    "    LI R1, 0x1000\n"
+    "loop:\n"
+    "    LOAD R2, 0(R1)\n"
+    "    ADDI R2, R2, 1\n"
+    "    STORE R2, 0(R1)\n"
+    "    XOR R3, R3, R2\n"
+    "    ADDI R4, R4, 1\n"
+    "    CMPI R4, 0\n"
+    "    BNE loop\n";
+
+void BM_InterpreterRun(benchmark::State& state) {
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kLoopProgram);
+    uint64_t steps = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(simulator.run(steps));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    state.counters["MIPS"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(steps) / 1e6,
+        benchmark::Counter::kIsRate);
+}
+
+// The same loop without block translation, one dispatch per instruction
+void BM_InterpreterRunUntranslated(benchmark::State& state) {
+    ProcessorSimulator::ProcessorState registers;
+    SimulatedMemory memory;
+    Program program = InstructionSet::assembleProgram(kLoopProgram, 0);
+    uint64_t steps = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Interpreter::run(registers, memory, program, steps));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    state.counters["MIPS"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(steps) / 1e6,
+        benchmark::Counter::kIsRate);
+}
+
+// The same loop recorded into a trace file
+void BM_InterpreterRunTraced(benchmark::State& state) {
+    const std::string path = "interpreter_benchmark_trace.bin";
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kLoopProgram);
+    uint64_t steps = static_cast<uint64_t>(state.range(0));
+    {
+        TraceWriter writer(path);
+        simulator.setTrace(&writer);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(simulator.run(steps));
+        }
+        simulator.setTrace(nullptr);
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+    state.counters["MIPS"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * static_cast<double>(steps) / 1e6,
+        benchmark::Counter::kIsRate);
+}
+
+// Text instructions through the decode cache
+void BM_ExecuteInstructionText(benchmark::State& state) {
+    ProcessorSimulator simulator;
+    const std::string add = "ADD R1, R1, R2";
+    simulator.executeInstruction("LI R2, 3");
+    for (auto _ : state) {
+        simulator.executeInstruction(add);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// Assembling a line every time, as executeInstruction would without the cache
+void BM_AssembleInstruction(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(InstructionSet::assemble("ADD R1, R1, R2"));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+} // namespace
+
+BENCHMARK(BM_InterpreterRun)->Arg(1 << 20);
+BENCHMARK(BM_InterpreterRunUntranslated)->Arg(1 << 20);
+BENCHMARK(BM_InterpreterRunTraced)->Arg(1 << 20);
+BENCHMARK(BM_ExecuteInstructionText);
+BENCHMARK(BM_AssembleInstruction);
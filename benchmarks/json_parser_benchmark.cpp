@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include <regex>
+#include <string>
+#include <vector>
+#include "../src/json_request_parser.hpp"
+#include "../src/processor_simulator.hpp"
+#include "../src/request_arena.hpp"
+
+namespace {
+
+// The original per-request std::regex extraction, kept as the baseline
+std::string legacyExtractBinary(const std::string& json) {
+    std::regex binaryRegex("\"binary\":\\s*\"([^\"]+)\"");
+    std::smatch match;
+    if (std::regex_search(json, match, binaryRegex)) {
+        return match[1].str();
+    }
+    return "1010";
+}
+
+std::string legacyExtractMode(const std::string& json) {
+    std::regex modeRegex("\"mode\":\\s*\"([^\"]+)\"");
+    std::smatch match;
+    if (std::regex_search(json, match, modeRegex)) {
+        return match[1].str();
+    }
+    return "STANDARD";
+}
+
+std::string makeRequestBody(size_t binaryLength) {
+    return "{\"binary\": \"" + std::string(binaryLength, '1') + "\", \"mode\": \"SIGNED\"}";
+}
+
+void BM_LegacyRegexExtraction(benchmark::State& state) {
+    std::string body = makeRequestBody(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyExtractBinary(body));
+        benchmark::DoNotOptimize(legacyExtractMode(body));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(body.size()));
+}
+
+void BM_JsonRequestParser(benchmark::State& state) {
+    std::string body = makeRequestBody(static_cast<size_t>(state.range(0)));
+    JsonRequestParser parser;
+    ConversionRequestFields request;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parser.parseRequest(body, request));
+        benchmark::DoNotOptimize(request.binary.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(body.size()));
+}
+
+std::string makeBatchBody(size_t items) {
+    std::string body = "{\"items\": [";
+    for (size_t i = 0; i < items; ++i) {
+        body += i > 0 ? ", " : "";
+        body += "{\"binary\": \"" + std::string(64, i % 2 ? '1' : '0') + "\", \"mode\": \"UNSIGNED\"}";
+    }
+    return body + "]}";
+}
+
+// Scratch of a batch request the way /convert/batch used to build it: a
+// vector of items, one string per result, then the joined response
+void BM_BatchScratchGlobal(benchmark::State& state) {
+    std::string body = makeBatchBody(static_cast<size_t>(state.range(0)));
+    JsonRequestParser parser;
+    for (auto _ : state) {
+        std::vector<ConversionRequestFields> items;
+        parser.parseBatch(body, items, 100000);
+        std::vector<std::string> results(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            results[i] = "{\"hex\": \"" + ProcessorSimulator::binaryToHex(items[i].binary, ConversionMode::UNSIGNED) + "\"}";
+        }
+        std::string response = "{\"results\": [";
+        for (const std::string& result : results) {
+            response += result;
+        }
+        benchmark::DoNotOptimize(response.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+// The same work with items and hex digits in the per-thread request arena
+void BM_BatchScratchArena(benchmark::State& state) {
+    std::string body = makeBatchBody(static_cast<size_t>(state.range(0)));
+    JsonRequestParser parser;
+    for (auto _ : state) {
+        RequestArena::Scope arena;
+        std::pmr::vector<ConversionRequestFields> items(arena.resource());
+        parser.parseBatch(body, items, 100000);
+        std::pmr::vector<size_t> offsets(items.size() + 1, 0, arena.resource());
+        for (size_t i = 0; i < items.size(); ++i) {
+            offsets[i + 1] = offsets[i] + ProcessorSimulator::maxHexLength(items[i].binary.size(), ConversionMode::UNSIGNED);
+        }
+        auto* hex = static_cast<char*>(arena.resource()->allocate(offsets.back(), 1));
+        std::pmr::vector<size_t> lengths(items.size(), arena.resource());
+        for (size_t i = 0; i < items.size(); ++i) {
+            lengths[i] = ProcessorSimulator::binaryToHex(items[i].binary, ConversionMode::UNSIGNED,
+                                                         hex + offsets[i], offsets[i + 1] - offsets[i]);
+        }
+        std::string response = "{\"results\": [";
+        for (size_t i = 0; i < items.size(); ++i) {
+            response += "{\"hex\": \"";
+            response.append(hex + offsets[i], lengths[i]);
+            response += "\"}";
+        }
+        benchmark::DoNotOptimize(response.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_LegacyRegexExtraction)->RangeMultiplier(16)->Range(8, 8 << 12);
+BENCHMARK(BM_JsonRequestParser)->RangeMultiplier(16)->Range(8, 8 << 12);
+BENCHMARK(BM_BatchScratchGlobal)->Arg(16)->Arg(1024);
+BENCHMARK(BM_BatchScratchArena)->Arg(16)->Arg(1024);
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include "../src/multi_core_simulator.hpp"
+#include "../src/thread_pool.hpp"
+
+namespace {
+
+// Each core updates its own counter word (R1 holds its address) in a loop
+const char* const kCoreProgram =
+    "loop:\n"
+    "    LOAD R2, 0(R1)\n"
+    "    ADDI R2, R2, 1\n"
+    "    STORE R2, 0(R1)\n"
+    "    XOR R3, R3, R2\n"
+    "    ADDI R4, R4, 1\n"
+    "    CMPI R4, 0\n"
+    "    BNE loop\n";
+
+constexpr uint64_t kStepsPerCore = 1 << 16;
+
+// Aggregate MIPS by host thread count for a fixed number of cores
+void BM_MultiCoreRun(benchmark::State& state) {
+    auto cores = static_cast<size_t>(state.range(0));
+    auto threads = static_cast<unsigned>(state.range(1));
+    ThreadPool pool(threads);
+    uint64_t executed = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto simulator = std::make_unique<MultiCoreSimulator>(pool);
+        simulator->setParallelism(threads);
+        simulator->addCores(cores, kCoreProgram);
+        for (size_t i = 0; i < cores; ++i) {
+            simulator->core(i).state.writeRegister(1, 0x100000 + i * 8);
+        }
+        state.ResumeTiming();
+
+        executed += simulator->run(kStepsPerCore);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(executed));
+    state.counters["MIPS"] = benchmark::Counter(static_cast<double>(executed) / 1e6, benchmark::Counter::kIsRate);
+    state.SetLabel(std::to_string(state.range(1)) + " threads");
+}
+
+} // namespace
+
+BENCHMARK(BM_MultiCoreRun)
+    ->ArgsProduct({{64, 1024}, {1, 2, 4, 8}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+const char* const kNames[] = {"R1", "R2", "R3", "R4", "R5", "R6", "R7", "R8"};
+
+// The original string-keyed register map, kept as the baseline
+void BM_LegacyRegisterMap(benchmark::State& state) {
+    std::unordered_map<std::string, uint64_t> registers;
+    for (const char* name : kNames) {
+        registers[name] = 1;
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const char* name = kNames[i++ & 7];
+        registers[name] = registers.find(name)->second + 1;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 2);
+}
+
+// Compatibility API: one name lookup per access
+void BM_RegisterByName(benchmark::State& state) {
+    ProcessorSimulator::ProcessorState registers;
+    std::string names[8];
+    for (size_t r = 0; r < 8; ++r) {
+        names[r] = kNames[r];
+        registers.setRegister(names[r], 1);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& name = names[i++ & 7];
+        registers.setRegister(name, registers.getRegister(name) + 1);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 2);
+}
+
+// Interpreter path: names resolved at decode time
+void BM_RegisterByIndex(benchmark::State& state) {
+    ProcessorSimulator::ProcessorState registers;
+    size_t i = 0;
+    for (auto _ : state) {
+        size_t index = (i++ & 7) + 1;
+        registers.writeRegister(index, registers.readRegister(index) + 1);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * 2);
+}
+
+} // namespace
+
+BENCHMARK(BM_LegacyRegisterMap);
+BENCHMARK(BM_RegisterByName);
+BENCHMARK(BM_RegisterByIndex);
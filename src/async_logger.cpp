@@ -0,0 +1,266 @@
+#include "async_logger.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "debug";
+        case LogLevel::INFO: return "info";
+        case LogLevel::WARNING: return "warning";
+        case LogLevel::ERROR: return "error";
+        case LogLevel::OFF: break;
+    }
+    return "off";
+}
+
+// Appends to a fixed buffer, silently truncating once it is full
+class LineWriter {
+public:
+    LineWriter(char* buffer, size_t capacity) : buffer(buffer), capacity(capacity) {}
+
+    void append(std::string_view text) {
+        size_t room = capacity - length;
+        size_t count = text.size() < room ? text.size() : room;
+        std::memcpy(buffer + length, text.data(), count);
+        length += count;
+        truncated |= count < text.size();
+    }
+
+    void append(char c) {
+        if (length < capacity) {
+            buffer[length++] = c;
+        } else {
+            truncated = true;
+        }
+    }
+
+    // logfmt value: quoted only when it contains spaces, quotes, '=' or control characters
+    void appendValue(std::string_view value) {
+        bool needsQuotes = value.empty();
+        for (char c : value) {
+            if (c == ' ' || c == '"' || c == '=' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+                needsQuotes = true;
+                break;
+            }
+        }
+        if (!needsQuotes) {
+            append(value);
+            return;
+        }
+
+        append('"');
+        for (char c : value) {
+            switch (c) {
+                case '"': append("\\\""); break;
+                case '\\': append("\\\\"); break;
+                case '\n': append("\\n"); break;
+                case '\r': append("\\r"); break;
+                case '\t': append("\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\x%02x", static_cast<unsigned char>(c));
+                        append(escaped);
+                    } else {
+                        append(c);
+                    }
+                    break;
+            }
+        }
+        append('"');
+    }
+
+    template <typename T>
+    void appendNumber(T value) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+    }
+
+    // Marks a cut-off line so readers know it is incomplete
+    size_t finish() {
+        if (truncated && capacity >= 3) {
+            std::memcpy(buffer + capacity - 3, "...", 3);
+            length = capacity;
+        }
+        return length;
+    }
+
+private:
+    char* buffer;
+    size_t capacity;
+    size_t length = 0;
+    bool truncated = false;
+};
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+LogLevel parseLogLevel(std::string_view name, LogLevel fallback) {
+    if (name == "debug") return LogLevel::DEBUG;
+    if (name == "info") return LogLevel::INFO;
+    if (name == "warning") return LogLevel::WARNING;
+    if (name == "error") return LogLevel::ERROR;
+    if (name == "off") return LogLevel::OFF;
+    return fallback;
+}
+
+AsyncLogger::AsyncLogger(std::ostream& out, LogLevel level, size_t capacity)
+    : out(out), minimumLevel(level) {
+    capacity = roundUpToPowerOfTwo(capacity);
+    slots = std::make_unique<Slot[]>(capacity);
+    mask = capacity - 1;
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer = std::thread([this]() { writerLoop(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+    stopping.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wakeUp.notify_one();
+    writer.join();
+}
+
+void AsyncLogger::log(LogLevel lineLevel, std::string_view event, std::initializer_list<LogField> fields) {
+    if (!enabled(lineLevel)) {
+        return;
+    }
+
+    // Claim a slot (bounded MPSC queue with per-slot sequence numbers)
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->time = std::chrono::system_clock::now();
+    slot->level = lineLevel;
+
+    LineWriter line(slot->text, kMaxLineBytes);
+    line.append(" level=");
+    line.append(levelName(lineLevel));
+    line.append(" event=");
+    line.appendValue(event);
+    for (const LogField& field : fields) {
+        line.append(' ');
+        line.append(field.key);
+        line.append('=');
+        switch (field.kind) {
+            case LogField::Kind::TEXT: line.appendValue(field.text); break;
+            case LogField::Kind::SIGNED: line.appendNumber(static_cast<int64_t>(field.integer)); break;
+            case LogField::Kind::UNSIGNED: line.appendNumber(field.integer); break;
+            case LogField::Kind::REAL: {
+                char digits[32];
+                std::snprintf(digits, sizeof(digits), "%g", field.real);
+                line.append(digits);
+                break;
+            }
+        }
+    }
+    slot->length = line.finish();
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    if (writerSleeping.load(std::memory_order_acquire)) {
+        wakeUp.notify_one();
+    }
+}
+
+void AsyncLogger::flush() {
+    size_t target = enqueuePos.load(std::memory_order_acquire);
+    while (dequeuePos.load(std::memory_order_acquire) < target) {
+        wakeUp.notify_one();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+void AsyncLogger::writerLoop() {
+    while (true) {
+        if (drain()) {
+            continue;
+        }
+        if (stopping.load(std::memory_order_acquire)) {
+            // Lines claimed before shutdown may still be in the middle of being written
+            if (dequeuePos.load(std::memory_order_relaxed) == enqueuePos.load(std::memory_order_acquire)) {
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        writerSleeping.store(true, std::memory_order_release);
+        // The timeout bounds the delay if a wake-up races with going to sleep
+        wakeUp.wait_for(lock, std::chrono::milliseconds(10));
+        writerSleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool AsyncLogger::drain() {
+    size_t capacity = mask + 1;
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    bool wroteAny = false;
+
+    while (true) {
+        Slot& slot = slots[pos & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            break;
+        }
+
+        // ts=2026-01-01T00:00:00.000Z
+        auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+            slot.time.time_since_epoch()).count();
+        std::time_t seconds = static_cast<std::time_t>(millis / 1000);
+        std::tm utc{};
+#ifdef _WIN32
+        gmtime_s(&utc, &seconds);
+#else
+        gmtime_r(&seconds, &utc);
+#endif
+        char timestamp[40];
+        size_t stamped = std::strftime(timestamp, sizeof(timestamp), "ts=%Y-%m-%dT%H:%M:%S", &utc);
+        std::snprintf(timestamp + stamped, sizeof(timestamp) - stamped, ".%03dZ",
+                      static_cast<int>(millis % 1000));
+
+        out << timestamp;
+        out.write(slot.text, static_cast<std::streamsize>(slot.length));
+        out << '\n';
+
+        slot.sequence.store(pos + capacity, std::memory_order_release);
+        ++pos;
+        dequeuePos.store(pos, std::memory_order_release);
+        wroteAny = true;
+    }
+
+    if (wroteAny) {
+        out.flush();
+    }
+    return wroteAny;
+}
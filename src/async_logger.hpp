@@ -0,0 +1,114 @@
+#ifndef ASYNC_LOGGER_HPP
+#define ASYNC_LOGGER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+enum class LogLevel {
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR,
+    OFF
+};
+
+// Parses "debug", "info", "warning", "error" or "off"; returns `fallback` otherwise
+LogLevel parseLogLevel(std::string_view name, LogLevel fallback = LogLevel::INFO);
+
+// One key=value pair of a structured log line
+class LogField {
+public:
+    LogField(std::string_view key, std::string_view value)
+        : key(key), kind(Kind::TEXT), text(value) {}
+    LogField(std::string_view key, const char* value)
+        : LogField(key, std::string_view(value)) {}
+    LogField(std::string_view key, double value)
+        : key(key), kind(Kind::REAL), real(value) {}
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    LogField(std::string_view key, T value)
+        : key(key),
+          kind(std::is_signed_v<T> ? Kind::SIGNED : Kind::UNSIGNED),
+          integer(static_cast<uint64_t>(value)) {}
+
+private:
+    friend class AsyncLogger;
+
+    enum class Kind { TEXT, SIGNED, UNSIGNED, REAL };
+
+    std::string_view key;
+    Kind kind;
+    std::string_view text;
+    uint64_t integer = 0;
+    double real = 0.0;
+};
+
+// Asynchronous structured (logfmt) logger.
+//
+// log() formats the line into a slot of a bounded lock-free ring buffer and
+// returns immediately; a background thread timestamps the lines and writes
+// them out in batches. When the ring is full, lines are dropped and counted
+// instead of blocking the caller.
+class AsyncLogger {
+public:
+    static constexpr size_t kDefaultCapacity = 4096;
+    static constexpr size_t kMaxLineBytes = 512;
+
+    explicit AsyncLogger(std::ostream& out = std::clog, LogLevel level = LogLevel::INFO,
+                         size_t capacity = kDefaultCapacity);
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    void setLevel(LogLevel newLevel) { minimumLevel.store(newLevel, std::memory_order_relaxed); }
+    LogLevel level() const { return minimumLevel.load(std::memory_order_relaxed); }
+    bool enabled(LogLevel lineLevel) const { return lineLevel >= level() && lineLevel != LogLevel::OFF; }
+
+    void log(LogLevel lineLevel, std::string_view event, std::initializer_list<LogField> fields = {});
+
+    // Block until every line logged before this call has been written
+    void flush();
+
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        std::chrono::system_clock::time_point time;
+        LogLevel level = LogLevel::INFO;
+        size_t length = 0;
+        char text[kMaxLineBytes];
+    };
+
+    void writerLoop();
+    bool drain();
+
+    std::ostream& out;
+    std::atomic<LogLevel> minimumLevel;
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) std::atomic<size_t> dequeuePos{0};
+    std::atomic<uint64_t> dropped{0};
+
+    // The writer sleeps here when the ring is empty
+    std::mutex wakeMutex;
+    std::condition_variable wakeUp;
+    std::atomic<bool> writerSleeping{false};
+    std::atomic<bool> stopping{false};
+    std::thread writer;
+};
+
+#endif // ASYNC_LOGGER_HPP
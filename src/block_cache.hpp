@@ -0,0 +1,41 @@
+#ifndef BLOCK_CACHE_HPP
+#define BLOCK_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct TranslatedBlock;
+
+// Translated blocks of one program for Interpreter::run, indexed by
+// instruction, with the execution counters that decide what to translate.
+//
+// Call clear() whenever the program is replaced, or changed other than by a
+// STORE the interpreter executed with this cache.
+class BlockCache {
+public:
+    // Interpreted executions of a PC before a block is translated from it
+    static constexpr uint32_t kHotThreshold = 16;
+    static constexpr size_t kMaxBlockInstructions = 64;
+
+    BlockCache();
+    ~BlockCache();
+    BlockCache(BlockCache&&) noexcept;
+    BlockCache& operator=(BlockCache&&) noexcept;
+
+    void clear();
+    size_t blockCount() const { return translated; }
+
+private:
+    friend class Interpreter;
+
+    // Drops every block and sizes the tables for `instructions` instructions
+    void reset(size_t instructions);
+
+    std::vector<uint32_t> counters;
+    std::vector<std::unique_ptr<TranslatedBlock>> blocks;
+    size_t translated = 0;
+};
+
+#endif // BLOCK_CACHE_HPP
@@ -0,0 +1,190 @@
+#include "cache_hierarchy.hpp"
+
+#include <algorithm>
+#include <utility>
+#include "processor_simulator.hpp"
+
+namespace {
+
+bool isPowerOfTwo(uint64_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+unsigned shiftFor(uint64_t value) {
+    unsigned shift = 0;
+    while ((uint64_t{1} << shift) < value) {
+        ++shift;
+    }
+    return shift;
+}
+
+size_t parseSize(std::string_view text) {
+    size_t multiplier = 1;
+    if (!text.empty() && (text.back() == 'K' || text.back() == 'k')) {
+        multiplier = 1024;
+        text.remove_suffix(1);
+    } else if (!text.empty() && (text.back() == 'M' || text.back() == 'm')) {
+        multiplier = 1024 * 1024;
+        text.remove_suffix(1);
+    }
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        throw ProcessorSimulatorException("Invalid cache size: " + std::string(text));
+    }
+    return static_cast<size_t>(std::stoull(std::string(text))) * multiplier;
+}
+
+} // namespace
+
+std::vector<CacheLevelConfig> CacheHierarchy::defaultLevels() {
+    return {
+        {"L1", 32 * 1024, 8, 64, 4},
+        {"L2", 1024 * 1024, 16, 64, 14},
+        {"LLC", 16 * 1024 * 1024, 16, 64, 42},
+    };
+}
+
+std::vector<CacheLevelConfig> CacheHierarchy::parseLevels(std::string_view spec) {
+    std::vector<CacheLevelConfig> result;
+    while (!spec.empty()) {
+        size_t comma = spec.find(',');
+        const std::string_view original = spec.substr(0, comma);
+        spec = comma == std::string_view::npos ? std::string_view() : spec.substr(comma + 1);
+
+        std::string_view entry = original;
+        std::vector<std::string_view> fields;
+        while (true) {
+            size_t colon = entry.find(':');
+            fields.push_back(entry.substr(0, colon));
+            if (colon == std::string_view::npos) {
+                break;
+            }
+            entry.remove_prefix(colon + 1);
+        }
+        if (fields.size() != 5 || fields[0].empty()) {
+            throw ProcessorSimulatorException("Cache levels are name:size:ways:line:latency, got: " +
+                                              std::string(original));
+        }
+        CacheLevelConfig level;
+        level.name = std::string(fields[0]);
+        level.sizeBytes = parseSize(fields[1]);
+        level.ways = static_cast<unsigned>(parseSize(fields[2]));
+        level.lineBytes = static_cast<unsigned>(parseSize(fields[3]));
+        level.latencyCycles = static_cast<unsigned>(parseSize(fields[4]));
+        result.push_back(level);
+    }
+    return result;
+}
+
+CacheHierarchy::CacheHierarchy(std::vector<CacheLevelConfig> configs, unsigned dramLatency)
+    : dramLatency(dramLatency) {
+    for (CacheLevelConfig& config : configs) {
+        uint64_t lineSets = config.ways > 0 && config.lineBytes > 0
+                                ? config.sizeBytes / (uint64_t{config.ways} * config.lineBytes)
+                                : 0;
+        if (!isPowerOfTwo(config.lineBytes) || !isPowerOfTwo(lineSets) ||
+            lineSets * config.ways * config.lineBytes != config.sizeBytes) {
+            throw ProcessorSimulatorException("Invalid geometry for cache level " + config.name);
+        }
+        Level level;
+        level.lineShift = shiftFor(config.lineBytes);
+        level.setMask = lineSets - 1;
+        level.tags.assign(lineSets * config.ways, kInvalidTag);
+        level.stamps.assign(lineSets * config.ways, 0);
+        level.dirty.assign(lineSets * config.ways, 0);
+        level.config = std::move(config);
+        levels.push_back(std::move(level));
+    }
+    stats.levels.resize(levels.size());
+}
+
+bool CacheHierarchy::lookup(Level& level, uint64_t line, bool write) {
+    size_t ways = level.config.ways;
+    size_t base = static_cast<size_t>(line & level.setMask) * ways;
+    const uint64_t* tags = level.tags.data() + base;
+    for (size_t way = 0; way < ways; ++way) {
+        if (tags[way] == line) {
+            level.stamps[base + way] = ++clock;
+            level.dirty[base + way] |= write ? 1 : 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CacheHierarchy::fill(size_t levelIndex, uint64_t line, bool write) {
+    Level& level = levels[levelIndex];
+    size_t ways = level.config.ways;
+    size_t base = static_cast<size_t>(line & level.setMask) * ways;
+
+    // Invalid ways have stamp 0, so they are taken first
+    size_t victim = base;
+    for (size_t way = base + 1; way < base + ways; ++way) {
+        if (level.stamps[way] < level.stamps[victim]) {
+            victim = way;
+        }
+    }
+
+    if (level.tags[victim] != kInvalidTag && level.dirty[victim]) {
+        if (counting) {
+            ++stats.levels[levelIndex].writebacks;
+        }
+        // The written-back line stays dirty in the next level if it is there
+        if (levelIndex + 1 < levels.size()) {
+            Level& next = levels[levelIndex + 1];
+            uint64_t evicted = (level.tags[victim] << level.lineShift) >> next.lineShift;
+            size_t nextBase = static_cast<size_t>(evicted & next.setMask) * next.config.ways;
+            for (size_t way = nextBase; way < nextBase + next.config.ways; ++way) {
+                if (next.tags[way] == evicted) {
+                    next.dirty[way] = 1;
+                    break;
+                }
+            }
+        }
+    }
+    level.tags[victim] = line;
+    level.stamps[victim] = ++clock;
+    level.dirty[victim] = write ? 1 : 0;
+}
+
+unsigned CacheHierarchy::access(uint64_t address, bool write) {
+    unsigned latency = 0;
+    size_t hitLevel = levels.size();
+    for (size_t i = 0; i < levels.size(); ++i) {
+        Level& level = levels[i];
+        latency += level.config.latencyCycles;
+        bool hit = lookup(level, address >> level.lineShift, write && i == 0);
+        if (counting) {
+            ++(hit ? stats.levels[i].hits : stats.levels[i].misses);
+        }
+        if (hit) {
+            hitLevel = i;
+            break;
+        }
+    }
+    if (hitLevel == levels.size()) {
+        latency += dramLatency;
+    }
+    for (size_t i = 0; i < hitLevel; ++i) {
+        fill(i, address >> levels[i].lineShift, write && i == 0);
+    }
+
+    if (counting) {
+        ++(write ? stats.stores : stats.loads);
+        stats.dramAccesses += hitLevel == levels.size() ? 1 : 0;
+        stats.cycles += latency;
+    }
+    return latency;
+}
+
+void CacheHierarchy::resetStats() {
+    stats = Stats();
+    stats.levels.resize(levels.size());
+}
+
+void CacheHierarchy::invalidate() {
+    for (Level& level : levels) {
+        std::fill(level.tags.begin(), level.tags.end(), kInvalidTag);
+        std::fill(level.stamps.begin(), level.stamps.end(), 0);
+        std::fill(level.dirty.begin(), level.dirty.end(), 0);
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef CACHE_HIERARCHY_HPP
+#define CACHE_HIERARCHY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Geometry and hit latency of one cache level
+struct CacheLevelConfig {
+    std::string name;
+    size_t sizeBytes = 0;
+    unsigned ways = 1;
+    unsigned lineBytes = 64;
+    unsigned latencyCycles = 1;
+};
+
+// Timing model of set-associative caches in front of DRAM, fed with the
+// addresses of the simulator's loads and stores.
+//
+// An access probes the levels in order and pays each probed level's latency,
+// plus the DRAM latency if every level misses. Misses allocate the line in
+// every level that missed (loads and stores alike); the least recently used
+// way is evicted, and evicting a line that was stored to counts a writeback.
+// Cycles are estimated for an in-order core: one per instruction plus the
+// latency of each access.
+//
+// Each level keeps its tags, LRU stamps and dirty bits in separate arrays
+// with the ways of a set adjacent, so a lookup scans one or two cache lines
+// of tags.
+class CacheHierarchy {
+public:
+    static constexpr unsigned kDefaultDramLatency = 200;
+
+    struct LevelStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t writebacks = 0;
+
+        double hitRate() const {
+            uint64_t accesses = hits + misses;
+            return accesses > 0 ? static_cast<double>(hits) / static_cast<double>(accesses) : 0.0;
+        }
+    };
+
+    struct Stats {
+        uint64_t instructions = 0;
+        uint64_t loads = 0;
+        uint64_t stores = 0;
+        uint64_t cycles = 0;
+        uint64_t dramAccesses = 0;
+        std::vector<LevelStats> levels;
+
+        double cyclesPerInstruction() const {
+            return instructions > 0 ? static_cast<double>(cycles) / static_cast<double>(instructions) : 0.0;
+        }
+    };
+
+    // 32 KiB L1, 1 MiB L2 and 16 MiB LLC
+    static std::vector<CacheLevelConfig> defaultLevels();
+
+    // Parses levels written "name:size:ways:line:latency" separated by commas,
+    // with K and M size suffixes, e.g. "L1:32K:8:64:4,L2:1M:16:64:14"
+    static std::vector<CacheLevelConfig> parseLevels(std::string_view spec);
+
+    // Throws ProcessorSimulatorException unless every level has a power-of-two
+    // line size and number of sets
+    explicit CacheHierarchy(std::vector<CacheLevelConfig> levels = defaultLevels(),
+                            unsigned dramLatency = kDefaultDramLatency);
+
+    // Models one access; returns its latency in cycles
+    unsigned access(uint64_t address, bool write);
+
+    // Accounts `count` executed instructions
+    void retire(uint64_t count) {
+        if (counting) {
+            stats.instructions += count;
+            stats.cycles += count;
+        }
+    }
+
+    // While false, accesses still update the caches but no statistics, so
+    // a warm-up period can fill them without being measured
+    void setCounting(bool enabled) { counting = enabled; }
+    bool isCounting() const { return counting; }
+
+    const Stats& getStats() const { return stats; }
+    void resetStats();
+
+    // Empties every level; statistics are kept
+    void invalidate();
+
+    size_t levelCount() const { return levels.size(); }
+    const CacheLevelConfig& levelConfig(size_t level) const { return levels[level].config; }
+
+private:
+    static constexpr uint64_t kInvalidTag = ~uint64_t{0};
+
+    struct Level {
+        CacheLevelConfig config;
+        unsigned lineShift = 0;
+        uint64_t setMask = 0;
+        std::vector<uint64_t> tags;    // sets * ways, the ways of a set adjacent
+        std::vector<uint64_t> stamps;  // Last use, for LRU
+        std::vector<uint8_t> dirty;
+    };
+
+    // Looks `line` up in `level`; on a hit refreshes it and returns true
+    bool lookup(Level& level, uint64_t line, bool write);
+    // Allocates `line` in `level`, evicting the least recently used way
+    void fill(size_t levelIndex, uint64_t line, bool write);
+
+    std::vector<Level> levels;
+    unsigned dramLatency;
+    uint64_t clock = 0;
+    bool counting = true;
+    Stats stats;
+};
+
+// Sampled simulation: alternates functional fast-forward, which runs at
+// full speed without the cache model, with detailed windows. Each window is
+// preceded by `warmup` instructions that refill the caches unmeasured.
+struct SamplingPlan {
+    uint64_t fastForward = 10'000'000;
+    uint64_t warmup = 100'000;
+    uint64_t window = 100'000;
+};
+
+// Outcome of ProcessorSimulator::runSampled
+struct SampledRun {
+    uint64_t instructions = 0;          // Executed in total
+    uint64_t detailedInstructions = 0;  // Measured in windows
+    uint64_t windows = 0;
+    double cyclesPerInstruction = 0.0;  // Over the windows
+    uint64_t estimatedCycles = 0;       // For the whole run
+};
+
+#endif // CACHE_HIERARCHY_HPP
@@ -0,0 +1,184 @@
+#include "checkpoint.hpp"
+#include "mapped_file.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr size_t kPageRecordWords = 1 + SimulatedMemory::kWrittenWords + SimulatedMemory::kPageWords;
+
+// Buffered writes that remember whether any of them failed
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::FILE* file) : file(file) {}
+
+    template <typename T>
+    void put(T value) {
+        write(&value, sizeof(value));
+    }
+
+    void write(const void* data, size_t size) {
+        ok = ok && std::fwrite(data, 1, size, file) == size;
+    }
+
+    bool succeeded() const { return ok; }
+
+private:
+    std::FILE* file;
+    bool ok = true;
+};
+
+// Bounds-checked reads from a mapped checkpoint
+class CheckpointReader {
+public:
+    CheckpointReader(const char* at, const char* end, const std::string& path)
+        : at(at), end(end), path(path) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    const char* take(size_t size) {
+        if (static_cast<size_t>(end - at) < size) {
+            throw ProcessorSimulatorException("Truncated checkpoint: " + path);
+        }
+        const char* data = at;
+        at += size;
+        return data;
+    }
+
+    size_t remaining() const { return static_cast<size_t>(end - at); }
+
+private:
+    const char* at;
+    const char* end;
+    const std::string& path;
+};
+
+} // namespace
+
+void Checkpoint::save(const std::string& path) const {
+    std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (file == nullptr) {
+        throw ProcessorSimulatorException("Cannot create checkpoint '" + temporary + "': " + std::strerror(errno));
+    }
+
+    CheckpointWriter out(file);
+    out.write(kMagic, sizeof(kMagic));
+    out.put(kVersion);
+    out.put(uint32_t{0});
+
+    uint16_t mask = state.getWrittenMask();
+    out.put(state.getPc());
+    out.put(state.getFlags());
+    out.put(static_cast<uint8_t>(state.isHalted() ? 1 : 0));
+    out.put(mask);
+    for (size_t i = 0; i < InstructionSet::kRegisterCount; ++i) {
+        if ((mask >> i & 1) != 0) {
+            out.put(state.readRegister(i));
+        }
+    }
+
+    const auto& named = state.getNamedRegisters();
+    out.put(static_cast<uint32_t>(named.size()));
+    for (const auto& [name, value] : named) {
+        out.put(static_cast<uint32_t>(name.size()));
+        out.write(name.data(), name.size());
+        out.put(value);
+    }
+
+    out.put(program.base);
+    out.put(static_cast<uint64_t>(program.code.size()));
+
+    // Pages in address order, so equal checkpoints produce identical files
+    std::vector<std::pair<uint64_t, std::pair<const uint64_t*, const uint64_t*>>> pages;
+    pages.reserve(memory.pageCount());
+    memory.forEachPage([&](uint64_t number, const uint64_t* words, const uint64_t* written) {
+        pages.push_back({number, {words, written}});
+    });
+    std::sort(pages.begin(), pages.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    out.put(static_cast<uint64_t>(pages.size()));
+    for (const auto& [number, page] : pages) {
+        out.put(number);
+        out.write(page.second, SimulatedMemory::kWrittenWords * sizeof(uint64_t));
+        out.write(page.first, SimulatedMemory::kPageBytes);
+    }
+
+    bool written = std::fclose(file) == 0 && out.succeeded();
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw ProcessorSimulatorException("Cannot write checkpoint '" + path + "'");
+    }
+}
+
+Checkpoint Checkpoint::load(const std::string& path) {
+    MappedFile file(path);
+    if (file.size() < sizeof(kMagic) + 8 || std::memcmp(file.data(), kMagic, sizeof(kMagic)) != 0) {
+        throw ProcessorSimulatorException("Not a checkpoint: " + path);
+    }
+    CheckpointReader in(file.data() + sizeof(kMagic), file.data() + file.size(), path);
+    auto version = in.get<uint32_t>();
+    if (version != kVersion) {
+        throw ProcessorSimulatorException("Unsupported checkpoint version " + std::to_string(version) +
+                                          " in " + path);
+    }
+    in.get<uint32_t>();
+
+    Checkpoint checkpoint;
+    ProcessorSimulator::ProcessorState& state = checkpoint.state;
+    state.setPc(in.get<uint64_t>());
+    state.setFlags(in.get<uint8_t>());
+    state.setHalted(in.get<uint8_t>() != 0);
+    auto mask = in.get<uint16_t>();
+    for (size_t i = 0; i < InstructionSet::kRegisterCount; ++i) {
+        if ((mask >> i & 1) != 0) {
+            state.writeRegister(i, in.get<uint64_t>());
+        }
+    }
+
+    auto namedCount = in.get<uint32_t>();
+    for (uint32_t i = 0; i < namedCount; ++i) {
+        auto length = in.get<uint32_t>();
+        std::string name(in.take(length), length);
+        state.setRegister(name, in.get<uint64_t>());
+    }
+
+    checkpoint.program.base = in.get<uint64_t>();
+    auto instructions = in.get<uint64_t>();
+
+    auto pageCount = in.get<uint64_t>();
+    if (pageCount > in.remaining() / (kPageRecordWords * sizeof(uint64_t))) {
+        throw ProcessorSimulatorException("Truncated checkpoint: " + path);
+    }
+    uint64_t written[SimulatedMemory::kWrittenWords];
+    uint64_t words[SimulatedMemory::kPageWords];
+    for (uint64_t i = 0; i < pageCount; ++i) {
+        auto number = in.get<uint64_t>();
+        std::memcpy(written, in.take(sizeof(written)), sizeof(written));
+        std::memcpy(words, in.take(sizeof(words)), sizeof(words));
+        checkpoint.memory.loadPage(number, words, written);
+    }
+    if (in.remaining() != 0) {
+        throw ProcessorSimulatorException("Unexpected data after checkpoint in " + path);
+    }
+
+    // loadProgram() stores the code, so it has to lie within the saved pages
+    if (instructions > pageCount * SimulatedMemory::kPageWords) {
+        throw ProcessorSimulatorException("Invalid program range in checkpoint " + path);
+    }
+    checkpoint.program.code.reserve(static_cast<size_t>(instructions));
+    for (uint64_t i = 0; i < instructions; ++i) {
+        uint64_t address = checkpoint.program.base + i * InstructionSet::kInstructionBytes;
+        checkpoint.program.code.push_back(Instruction::decode(checkpoint.memory.load64(address)));
+    }
+    return checkpoint;
+}
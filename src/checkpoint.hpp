@@ -0,0 +1,46 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <string>
+#include "instruction_set.hpp"
+#include "processor_simulator.hpp"
+#include "simulated_memory.hpp"
+
+// A saved ProcessorSimulator, taken with ProcessorSimulator::checkpoint().
+//
+// The memory is a copy-on-write copy, so a checkpoint costs a register file
+// plus the decoded program however much memory is in use, and restoring it
+// is just as cheap. Any number of simulators can be forked from one
+// checkpoint; each copies a 4 KiB page only when it first writes to it.
+//
+// save() writes a versioned binary file, in host byte order:
+//
+//   header   "PSCHKPT1", u32 version, u32 reserved (0)
+//   state    u64 PC, u8 flags, u8 halted, u16 written-register mask,
+//            u64 per written register
+//   named    u32 count, then per register: u32 name length, name, u64 value
+//   program  u64 base, u64 instruction count
+//   memory   u64 page count, then per page in address order:
+//            u64 page number, u64 x 8 written-word bitmap, u64 x 512 words
+//
+// The decoded program is not stored: load() decodes it again from memory.
+struct Checkpoint {
+    static constexpr char kMagic[8] = {'P', 'S', 'C', 'H', 'K', 'P', 'T', '1'};
+    static constexpr uint32_t kVersion = 1;
+
+    ProcessorSimulator::ProcessorState state;
+    SimulatedMemory memory;
+    Program program;
+
+    // Writes the checkpoint to `path` through a temporary file, so an
+    // existing checkpoint is only replaced once the new one is complete.
+    // Throws ProcessorSimulatorException on failure.
+    void save(const std::string& path) const;
+
+    // Throws ProcessorSimulatorException if `path` is not a complete
+    // checkpoint of a supported version
+    static Checkpoint load(const std::string& path);
+};
+
+#endif // CHECKPOINT_HPP
@@ -0,0 +1,335 @@
+#include "conversion_engine.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CONVERSION_ENGINE_X86 1
+#include <immintrin.h>
+#define CONVERSION_TARGET_SSE2 __attribute__((target("sse2")))
+#define CONVERSION_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define CONVERSION_ENGINE_X86 1
+#include <immintrin.h>
+#include <intrin.h>
+#define CONVERSION_TARGET_SSE2
+#define CONVERSION_TARGET_AVX2
+#endif
+
+namespace {
+
+constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+// Every '0'/'1' byte has the form 0011000x
+constexpr uint64_t kAsciiBitMask = 0xFEFEFEFEFEFEFEFEULL;
+constexpr uint64_t kAsciiZeros = 0x3030303030303030ULL;
+
+// Maps an 8-bit movemask (bit 0 = first character) to the two hex digits
+// of the corresponding byte (first character = most significant bit)
+constexpr std::array<char, 512> makeMaskPairDigits() {
+    std::array<char, 512> table{};
+    for (int mask = 0; mask < 256; ++mask) {
+        int value = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            if (mask & (1 << bit)) {
+                value |= 0x80 >> bit;
+            }
+        }
+        table[mask * 2] = kHexDigits[value >> 4];
+        table[mask * 2 + 1] = kHexDigits[value & 0xF];
+    }
+    return table;
+}
+
+constexpr std::array<char, 512> kMaskPairDigits = makeMaskPairDigits();
+
+// Value of every hex digit character, 0xFF for anything else
+constexpr std::array<unsigned char, 256> makeDigitValues() {
+    std::array<unsigned char, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = c >= '0' && c <= '9' ? static_cast<unsigned char>(c - '0')
+                 : c >= 'A' && c <= 'F' ? static_cast<unsigned char>(c - 'A' + 10)
+                 : c >= 'a' && c <= 'f' ? static_cast<unsigned char>(c - 'a' + 10)
+                 : 0xFF;
+    }
+    return table;
+}
+
+constexpr std::array<unsigned char, 256> kDigitValues = makeDigitValues();
+
+// The four ASCII bits of every nibble value
+constexpr std::array<char, 64> makeNibbleBits() {
+    std::array<char, 64> table{};
+    for (int value = 0; value < 16; ++value) {
+        for (int bit = 0; bit < 4; ++bit) {
+            table[value * 4 + bit] = (value & (8 >> bit)) ? '1' : '0';
+        }
+    }
+    return table;
+}
+
+constexpr std::array<char, 64> kNibbleBits = makeNibbleBits();
+
+inline bool nibbleValue(const char* bits, size_t count, unsigned& value) {
+    value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        unsigned bit = static_cast<unsigned char>(bits[i]) - '0';
+        if (bit > 1) {
+            return false;
+        }
+        value = (value << 1) | bit;
+    }
+    return true;
+}
+
+// Portable kernel: validates and packs 8 characters per 64-bit load
+bool convertScalar(const char* bits, size_t nibbleCount, char* out) {
+    size_t i = 0;
+    for (; i + 2 <= nibbleCount; i += 2) {
+        uint64_t word;
+        std::memcpy(&word, bits + i * 4, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        if ((word & kAsciiBitMask) != kAsciiZeros) {
+            return false;
+        }
+        // Gather bit 0 of every byte into one byte, first character first
+        unsigned byte = static_cast<unsigned>(
+            ((word & 0x0101010101010101ULL) * 0x8040201008040201ULL) >> 56);
+        out[i] = kHexDigits[byte >> 4];
+        out[i + 1] = kHexDigits[byte & 0xF];
+    }
+    if (i < nibbleCount) {
+        unsigned value;
+        if (!nibbleValue(bits + i * 4, 4, value)) {
+            return false;
+        }
+        out[i] = kHexDigits[value];
+    }
+    return true;
+}
+
+// Portable reverse kernel: one table lookup per digit
+bool hexToBinaryScalar(const char* hex, size_t digitCount, char* out) {
+    for (size_t i = 0; i < digitCount; ++i) {
+        unsigned value = kDigitValues[static_cast<unsigned char>(hex[i])];
+        if (value > 0xF) {
+            return false;
+        }
+        std::memcpy(out + i * 4, &kNibbleBits[value * 4], 4);
+    }
+    return true;
+}
+
+#ifdef CONVERSION_ENGINE_X86
+
+// 16 characters -> 4 hex digits per iteration
+CONVERSION_TARGET_SSE2
+bool convertSse2(const char* bits, size_t nibbleCount, char* out) {
+    const __m128i highMask = _mm_set1_epi8(static_cast<char>(0xFE));
+    const __m128i zeros = _mm_set1_epi8('0');
+
+    size_t i = 0;
+    for (; i + 4 <= nibbleCount; i += 4) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + i * 4));
+        __m128i valid = _mm_cmpeq_epi8(_mm_and_si128(chars, highMask), zeros);
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            return false;
+        }
+        // Move bit 0 of every byte into its sign bit and collect the mask
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_slli_epi16(chars, 7)));
+        std::memcpy(out + i, &kMaskPairDigits[(mask & 0xFF) * 2], 2);
+        std::memcpy(out + i + 2, &kMaskPairDigits[(mask >> 8) * 2], 2);
+    }
+    return convertScalar(bits + i * 4, nibbleCount - i, out + i);
+}
+
+// 32 characters -> 8 hex digits per iteration
+CONVERSION_TARGET_AVX2
+bool convertAvx2(const char* bits, size_t nibbleCount, char* out) {
+    const __m256i highMask = _mm256_set1_epi8(static_cast<char>(0xFE));
+    const __m256i zeros = _mm256_set1_epi8('0');
+
+    size_t i = 0;
+    for (; i + 8 <= nibbleCount; i += 8) {
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i * 4));
+        __m256i valid = _mm256_cmpeq_epi8(_mm256_and_si256(chars, highMask), zeros);
+        if (_mm256_movemask_epi8(valid) != -1) {
+            return false;
+        }
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(chars, 7)));
+        std::memcpy(out + i, &kMaskPairDigits[(mask & 0xFF) * 2], 2);
+        std::memcpy(out + i + 2, &kMaskPairDigits[((mask >> 8) & 0xFF) * 2], 2);
+        std::memcpy(out + i + 4, &kMaskPairDigits[((mask >> 16) & 0xFF) * 2], 2);
+        std::memcpy(out + i + 6, &kMaskPairDigits[(mask >> 24) * 2], 2);
+    }
+    return convertSse2(bits + i * 4, nibbleCount - i, out + i);
+}
+
+// 16 hex digits -> 64 characters per iteration
+CONVERSION_TARGET_SSE2
+bool hexToBinarySse2(const char* hex, size_t digitCount, char* out) {
+    const __m128i zeroChar = _mm_set1_epi8('0');
+    // Output byte k of each group of four tests bit 3 - k of its nibble
+    const __m128i bitSelect = _mm_set_epi8(1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8, 1, 2, 4, 8);
+
+    size_t i = 0;
+    for (; i + 16 <= digitCount; i += 16) {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + i));
+        // Signed compares also reject bytes >= 0x80
+        __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+        __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+        __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                         _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+        if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF) {
+            return false;
+        }
+        __m128i nibbles = _mm_or_si128(
+            _mm_and_si128(isDigit, _mm_sub_epi8(chars, zeroChar)),
+            _mm_andnot_si128(isDigit, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+        // Repeat every nibble four times, then test one bit per byte
+        __m128i pairsLow = _mm_unpacklo_epi8(nibbles, nibbles);
+        __m128i pairsHigh = _mm_unpackhi_epi8(nibbles, nibbles);
+        __m128i quads[4] = {_mm_unpacklo_epi16(pairsLow, pairsLow), _mm_unpackhi_epi16(pairsLow, pairsLow),
+                            _mm_unpacklo_epi16(pairsHigh, pairsHigh), _mm_unpackhi_epi16(pairsHigh, pairsHigh)};
+        for (int q = 0; q < 4; ++q) {
+            __m128i set = _mm_cmpeq_epi8(_mm_and_si128(quads[q], bitSelect), bitSelect);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4 + q * 16), _mm_sub_epi8(zeroChar, set));
+        }
+    }
+    return hexToBinaryScalar(hex + i, digitCount - i, out + i * 4);
+}
+
+bool cpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool cpuSupportsSse2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return true;  // Baseline on x86-64
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif // CONVERSION_ENGINE_X86
+
+using Kernel = bool (*)(const char*, size_t, char*);
+
+Kernel kernelFor(ConversionEngine::Isa isa) {
+    switch (isa) {
+#ifdef CONVERSION_ENGINE_X86
+        case ConversionEngine::Isa::AVX2:
+            return convertAvx2;
+        case ConversionEngine::Isa::SSE2:
+            return convertSse2;
+#endif
+        default:
+            return convertScalar;
+    }
+}
+
+bool isaSupported(ConversionEngine::Isa isa) {
+    return static_cast<int>(isa) <= static_cast<int>(ConversionEngine::detectIsa());
+}
+
+std::atomic<Kernel> activeKernel{nullptr};
+std::atomic<ConversionEngine::Isa> activeKernelIsa{ConversionEngine::Isa::SCALAR};
+
+Kernel currentKernel() {
+    Kernel kernel = activeKernel.load(std::memory_order_acquire);
+    if (kernel == nullptr) {
+        ConversionEngine::Isa isa = ConversionEngine::detectIsa();
+        activeKernelIsa.store(isa, std::memory_order_relaxed);
+        kernel = kernelFor(isa);
+        activeKernel.store(kernel, std::memory_order_release);
+    }
+    return kernel;
+}
+
+} // namespace
+
+ConversionEngine::Isa ConversionEngine::detectIsa() {
+#ifdef CONVERSION_ENGINE_X86
+    static const Isa detected = cpuSupportsAvx2() ? Isa::AVX2
+                              : cpuSupportsSse2() ? Isa::SSE2
+                                                  : Isa::SCALAR;
+    return detected;
+#else
+    return Isa::SCALAR;
+#endif
+}
+
+ConversionEngine::Isa ConversionEngine::activeIsa() {
+    currentKernel();
+    return activeKernelIsa.load(std::memory_order_relaxed);
+}
+
+void ConversionEngine::setActiveIsa(Isa isa) {
+    if (!isaSupported(isa)) {
+        throw std::invalid_argument(std::string("Instruction set not supported: ") + isaName(isa));
+    }
+    activeKernelIsa.store(isa, std::memory_order_relaxed);
+    activeKernel.store(kernelFor(isa), std::memory_order_release);
+}
+
+const char* ConversionEngine::isaName(Isa isa) {
+    switch (isa) {
+        case Isa::SCALAR:
+            return "scalar";
+        case Isa::SSE2:
+            return "sse2";
+        case Isa::AVX2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+bool ConversionEngine::binaryToHex(const char* bits, size_t count, char* out) {
+    // A partial leading group becomes the first (zero-padded) digit
+    size_t leading = count % 4;
+    if (leading != 0) {
+        unsigned value;
+        if (!nibbleValue(bits, leading, value)) {
+            return false;
+        }
+        *out++ = kHexDigits[value];
+        bits += leading;
+    }
+    return convertAligned(bits, count / 4, out);
+}
+
+bool ConversionEngine::convertAligned(const char* bits, size_t nibbleCount, char* out) {
+    return currentKernel()(bits, nibbleCount, out);
+}
+
+bool ConversionEngine::hexToBinary(const char* hex, size_t digitCount, char* out) {
+#ifdef CONVERSION_ENGINE_X86
+    if (activeIsa() != Isa::SCALAR) {
+        return hexToBinarySse2(hex, digitCount, out);
+    }
+#endif
+    return hexToBinaryScalar(hex, digitCount, out);
+}
@@ -0,0 +1,54 @@
+#ifndef CONVERSION_ENGINE_HPP
+#define CONVERSION_ENGINE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Table-driven binary-text to hex-text conversion kernels.
+//
+// The engine reads ASCII '0'/'1' characters in place and writes uppercase
+// hex digits into a caller-provided buffer. On x86 it packs 16 (SSE2) or
+// 32 (AVX2) characters per step, selected at runtime; every other target
+// uses a portable 8-characters-per-step SWAR kernel. The reverse direction
+// expands 16 hex digits per step with SSE2 (also used when AVX2 is active)
+// and one digit per table lookup otherwise.
+class ConversionEngine {
+public:
+    // Instruction set used by the aligned kernel
+    enum class Isa {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+
+    // Best instruction set supported by the running CPU
+    static Isa detectIsa();
+
+    // Instruction set currently used for conversions
+    static Isa activeIsa();
+
+    // Force a specific kernel (e.g. for benchmarks); throws
+    // std::invalid_argument if the CPU does not support it
+    static void setActiveIsa(Isa isa);
+
+    static const char* isaName(Isa isa);
+
+    // Number of hex digits produced for a given number of input bits
+    static size_t hexLength(size_t bitCount) { return (bitCount + 3) / 4; }
+
+    // Convert `count` ASCII bits into hexLength(count) hex digits at `out`.
+    // The input is treated as left-padded with zeros to a multiple of 4.
+    // Returns false if the input contains anything other than '0' or '1';
+    // the contents of `out` are unspecified in that case.
+    static bool binaryToHex(const char* bits, size_t count, char* out);
+
+    // Convert exactly `nibbleCount` complete nibbles (4 * nibbleCount bits)
+    static bool convertAligned(const char* bits, size_t nibbleCount, char* out);
+
+    // Convert `digitCount` hex digits (either case) into 4 * digitCount ASCII
+    // bits at `out`. Returns false if the input contains a non-hex character;
+    // the contents of `out` are unspecified in that case.
+    static bool hexToBinary(const char* hex, size_t digitCount, char* out);
+};
+
+#endif // CONVERSION_ENGINE_HPP
@@ -0,0 +1,48 @@
+#include "conversion_response.hpp"
+#include "json_request_parser.hpp"
+#include "result_cache.hpp"
+
+#include <cstring>
+
+ConversionMode ConversionResponse::parseMode(std::string_view mode) {
+    if (mode == "SIGNED") {
+        return ConversionMode::SIGNED;
+    } else if (mode == "UNSIGNED") {
+        return ConversionMode::UNSIGNED;
+    } else if (mode == "FLOATING_POINT") {
+        return ConversionMode::FLOATING_POINT;
+    }
+    return ConversionMode::STANDARD;
+}
+
+size_t ConversionResponse::convert(std::string_view binary, ConversionMode mode, ConversionResultCache* cache,
+                                   char* out, size_t capacity) {
+    if (cache != nullptr && cache->mayCache(binary.size())) {
+        ConversionResultCache::Result hex = cache->convert(mode, binary);
+        std::memcpy(out, hex->data(), hex->size());
+        return hex->size();
+    }
+    return ProcessorSimulator::binaryToHex(binary, mode, out, capacity);
+}
+
+bool ConversionResponse::write(std::string_view binary, ConversionMode mode, ConversionResultCache* cache,
+                               std::string& body) {
+    size_t capacity = ProcessorSimulator::maxHexLength(binary.size(), mode);
+    try {
+        body.assign(kHexPrefix);
+        body.resize(kHexPrefix.size() + capacity);
+        size_t length = convert(binary, mode, cache, &body[kHexPrefix.size()], capacity);
+        body.resize(kHexPrefix.size() + length);
+        body += kHexSuffix;
+        return true;
+    } catch (const ProcessorSimulatorException& e) {
+        writeError(e.what(), body);
+        return false;
+    }
+}
+
+void ConversionResponse::writeError(std::string_view message, std::string& body) {
+    body.assign("{\"error\": \"");
+    appendJsonEscaped(body, message);
+    body += "\"}";
+}
@@ -0,0 +1,38 @@
+#ifndef CONVERSION_RESPONSE_HPP
+#define CONVERSION_RESPONSE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "processor_simulator.hpp"
+
+class ConversionResultCache;
+
+// JSON response bodies for conversion requests, shared by the HTTP and
+// FastCGI front ends. Bodies are written into caller strings so a worker can
+// reuse one buffer across requests.
+class ConversionResponse {
+public:
+    static constexpr std::string_view kHexPrefix = "{\"hex\": \"";
+    static constexpr std::string_view kHexSuffix = "\"}";
+
+    // Unknown modes fall back to STANDARD
+    static ConversionMode parseMode(std::string_view mode);
+
+    // Converts `binary` into `out`, which holds `capacity` >= maxHexLength()
+    // characters, through `cache` for inputs it may hold (nullptr converts
+    // directly); returns the hex length. Throws ProcessorSimulatorException
+    // for invalid input.
+    static size_t convert(std::string_view binary, ConversionMode mode, ConversionResultCache* cache,
+                          char* out, size_t capacity);
+
+    // Writes {"hex": ...} into `body`, or {"error": ...} for invalid input,
+    // in which case it returns false. Hex digits and formatted reals never
+    // need escaping.
+    static bool write(std::string_view binary, ConversionMode mode, ConversionResultCache* cache,
+                      std::string& body);
+
+    static void writeError(std::string_view message, std::string& body);
+};
+
+#endif // CONVERSION_RESPONSE_HPP
@@ -0,0 +1,379 @@
+#include "execution_trace.hpp"
+#include "simulated_memory.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+namespace {
+
+template <typename T>
+T get(const char* at) {
+    T value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+template <typename T>
+void append(std::vector<char>& out, T value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+size_t stepBytes(uint8_t effects) {
+    size_t bytes = 1;
+    if (effects & TraceFormat::kRegister) {
+        bytes += 1 + 8;
+    }
+    if (effects & TraceFormat::kFlags) {
+        bytes += 1;
+    }
+    if (effects & TraceFormat::kStore) {
+        bytes += 8 + 8;
+    }
+    if (effects & TraceFormat::kJump) {
+        bytes += 8;
+    }
+    return bytes;
+}
+
+// Snapshot fields before the register values
+constexpr size_t kSnapshotFixedBytes = 1 + 8 + 8 + 1 + 1 + 2;
+
+size_t popcount16(uint16_t mask) {
+    size_t count = 0;
+    for (; mask != 0; mask &= static_cast<uint16_t>(mask - 1)) {
+        ++count;
+    }
+    return count;
+}
+
+} // namespace
+
+TraceWriter::TraceWriter(const std::string& path, uint32_t snapshotInterval)
+    : path(path), file(std::fopen(path.c_str(), "wb")), interval(std::max<uint32_t>(snapshotInterval, 1)), untilSnapshot(interval) {
+    if (file == nullptr) {
+        throw ProcessorSimulatorException("Cannot create trace '" + path + "': " + std::strerror(errno));
+    }
+
+    std::vector<char> header(TraceFormat::kMagic, TraceFormat::kMagic + sizeof(TraceFormat::kMagic));
+    append(header, TraceFormat::kVersion);
+    append(header, interval);
+    if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+        std::fclose(file);
+        throw ProcessorSimulatorException("Cannot write trace '" + path + "'");
+    }
+
+    block.resize(kBlockBytes);
+    cursor = block.data();
+    blockEnd = cursor + block.size();
+    writer = std::thread(&TraceWriter::writerLoop, this);
+}
+
+TraceWriter::~TraceWriter() {
+    try {
+        close();
+    } catch (const ProcessorSimulatorException&) {
+        // Nothing to report to from a destructor; call close() to see errors
+    }
+}
+
+TraceWriter::RecordedState TraceWriter::RecordedState::of(const State& state) {
+    RecordedState recorded;
+    recorded.pc = state.getPc();
+    recorded.flags = state.getFlags();
+    recorded.halted = state.isHalted();
+    recorded.writtenMask = state.getWrittenMask();
+    for (size_t i = 0; i < InstructionSet::kRegisterCount; ++i) {
+        recorded.registers[i] = state.readRegister(i);
+    }
+    return recorded;
+}
+
+bool TraceWriter::RecordedState::operator==(const RecordedState& other) const {
+    return pc == other.pc && flags == other.flags && halted == other.halted &&
+           writtenMask == other.writtenMask && registers == other.registers;
+}
+
+void TraceWriter::begin(const State& state) {
+    if (snapshots.empty() || !(RecordedState::of(state) == last)) {
+        snapshot(state);
+    }
+}
+
+void TraceWriter::snapshot(const State& state) {
+    if (static_cast<size_t>(blockEnd - cursor) < kMaxSnapshotBytes) {
+        rotate();
+    }
+    snapshots.emplace_back(steps, blockOffset + static_cast<uint64_t>(cursor - block.data()));
+
+    uint16_t mask = state.getWrittenMask();
+    *cursor++ = static_cast<char>(TraceFormat::kSnapshotTag);
+    put(steps);
+    put(state.getPc());
+    *cursor++ = static_cast<char>(state.getFlags());
+    *cursor++ = static_cast<char>(state.isHalted() ? 1 : 0);
+    std::memcpy(cursor, &mask, sizeof(mask));
+    cursor += sizeof(mask);
+    for (size_t i = 0; i < InstructionSet::kRegisterCount; ++i) {
+        if ((mask >> i & 1) != 0) {
+            put(state.readRegister(i));
+        }
+    }
+}
+
+void TraceWriter::rotate() {
+    size_t used = static_cast<size_t>(cursor - block.data());
+    std::vector<char> next;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        blockWritten.wait(lock, [this]() { return queue.size() < kMaxQueuedBlocks; });
+        queue.push_back(Block{std::move(block), used});
+        if (!spareBlocks.empty()) {
+            next = std::move(spareBlocks.back());
+            spareBlocks.pop_back();
+        }
+    }
+    blockQueued.notify_one();
+
+    if (next.empty()) {
+        next.resize(kBlockBytes);
+    }
+    block = std::move(next);
+    blockOffset += used;
+    cursor = block.data();
+    blockEnd = cursor + block.size();
+}
+
+void TraceWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        blockQueued.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            return;
+        }
+        Block next = std::move(queue.front());
+        queue.pop_front();
+
+        lock.unlock();
+        bool written = std::fwrite(next.data.data(), 1, next.size, file) == next.size;
+        lock.lock();
+
+        writeFailed = writeFailed || !written;
+        spareBlocks.push_back(std::move(next.data));
+        blockWritten.notify_all();
+    }
+}
+
+void TraceWriter::close() {
+    if (closed) {
+        return;
+    }
+    closed = true;
+
+    rotate();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    blockQueued.notify_one();
+    writer.join();
+
+    uint64_t indexOffset = blockOffset;
+    std::vector<char> index;
+    index.push_back(static_cast<char>(TraceFormat::kIndexTag));
+    append(index, steps);
+    append(index, static_cast<uint64_t>(snapshots.size()));
+    for (const auto& [step, offset] : snapshots) {
+        append(index, step);
+        append(index, offset);
+    }
+    append(index, indexOffset);
+    index.insert(index.end(), TraceFormat::kIndexMagic, TraceFormat::kIndexMagic + sizeof(TraceFormat::kIndexMagic));
+
+    bool written = !writeFailed && std::fwrite(index.data(), 1, index.size(), file) == index.size();
+    written = std::fclose(file) == 0 && written;
+    block = std::vector<char>();
+    spareBlocks.clear();
+    if (!written) {
+        throw ProcessorSimulatorException("Cannot write trace '" + path + "'");
+    }
+}
+
+TraceReader::TraceReader(const std::string& path)
+    : file(path), begin(file.data()), end(file.data() + file.size()) {
+    if (file.size() < TraceFormat::kHeaderBytes ||
+        std::memcmp(begin, TraceFormat::kMagic, sizeof(TraceFormat::kMagic)) != 0) {
+        throw ProcessorSimulatorException("Not an execution trace: " + path);
+    }
+    if (get<uint32_t>(begin + 8) != TraceFormat::kVersion) {
+        throw ProcessorSimulatorException("Unsupported trace version in " + path);
+    }
+    interval = get<uint32_t>(begin + 12);
+
+    if (!readIndex()) {
+        scan();
+    }
+    if (snapshots.empty() || snapshots.front().first != 0) {
+        throw ProcessorSimulatorException("Execution trace has no initial state: " + path);
+    }
+}
+
+size_t TraceReader::recordBytes(const char* at, const char* end) {
+    auto available = static_cast<size_t>(end - at);
+    if (available == 0) {
+        return 0;
+    }
+    auto tag = static_cast<uint8_t>(*at);
+    size_t bytes;
+    if (tag == TraceFormat::kSnapshotTag) {
+        if (available < kSnapshotFixedBytes) {
+            return 0;
+        }
+        bytes = kSnapshotFixedBytes + 8 * popcount16(get<uint16_t>(at + kSnapshotFixedBytes - 2));
+    } else if (tag < TraceFormat::kSnapshotTag) {
+        bytes = stepBytes(tag);
+    } else {
+        return 0;  // The index, or garbage
+    }
+    return bytes <= available ? bytes : 0;
+}
+
+uint64_t TraceReader::readSnapshot(const char* at, State& state) {
+    uint64_t step = get<uint64_t>(at + 1);
+    state.reset();
+    state.setPc(get<uint64_t>(at + 9));
+    state.setFlags(static_cast<uint8_t>(at[17]));
+    state.setHalted(at[18] != 0);
+    auto mask = get<uint16_t>(at + 19);
+    const char* value = at + kSnapshotFixedBytes;
+    for (size_t i = 0; i < InstructionSet::kRegisterCount; ++i) {
+        if ((mask >> i & 1) != 0) {
+            state.writeRegister(i, get<uint64_t>(value));
+            value += 8;
+        }
+    }
+    return step;
+}
+
+bool TraceReader::readIndex() {
+    auto size = static_cast<size_t>(end - begin);
+    if (size < TraceFormat::kHeaderBytes + TraceFormat::kFooterBytes ||
+        std::memcmp(end - 8, TraceFormat::kIndexMagic, sizeof(TraceFormat::kIndexMagic)) != 0) {
+        return false;
+    }
+    uint64_t indexOffset = get<uint64_t>(end - TraceFormat::kFooterBytes);
+    if (indexOffset < TraceFormat::kHeaderBytes || indexOffset + 17 > size - TraceFormat::kFooterBytes) {
+        return false;
+    }
+    const char* index = begin + indexOffset;
+    uint64_t count = get<uint64_t>(index + 9);
+    if (static_cast<uint8_t>(*index) != TraceFormat::kIndexTag ||
+        count > (size - TraceFormat::kFooterBytes - indexOffset - 17) / 16) {
+        return false;
+    }
+
+    steps = get<uint64_t>(index + 1);
+    snapshots.resize(static_cast<size_t>(count));
+    for (size_t i = 0; i < snapshots.size(); ++i) {
+        snapshots[i] = {get<uint64_t>(index + 17 + i * 16), get<uint64_t>(index + 25 + i * 16)};
+    }
+    end = index;
+    return true;
+}
+
+void TraceReader::scan() {
+    const char* at = begin + TraceFormat::kHeaderBytes;
+    uint64_t step = 0;
+    while (size_t bytes = recordBytes(at, end)) {
+        if (static_cast<uint8_t>(*at) == TraceFormat::kSnapshotTag) {
+            snapshots.emplace_back(step, static_cast<uint64_t>(at - begin));
+        } else {
+            ++step;
+        }
+        at += bytes;
+    }
+    steps = step;
+    end = at;  // Drop a truncated final record
+}
+
+TraceReader::Cursor TraceReader::seek(uint64_t step) const {
+    if (step > steps) {
+        throw ProcessorSimulatorException("Trace step " + std::to_string(step) + " is past the end (" +
+                                          std::to_string(steps) + " steps)");
+    }
+
+    // The last snapshot at or before `step`
+    auto it = std::upper_bound(snapshots.begin(), snapshots.end(), step,
+        [](uint64_t target, const std::pair<uint64_t, uint64_t>& entry) { return target < entry.first; });
+    const char* at = begin + std::prev(it)->second;
+
+    Cursor cursor(at, end, 0);
+    cursor.steps = readSnapshot(at, cursor.current);
+    cursor.at = at + recordBytes(at, end);
+    TraceStep skipped;
+    while (cursor.steps < step && cursor.next(skipped)) {
+    }
+    return cursor;
+}
+
+bool TraceReader::Cursor::next(TraceStep& step) {
+    loadSnapshots();
+    size_t bytes = recordBytes(at, end);
+    if (bytes == 0) {
+        return false;
+    }
+    auto tag = static_cast<uint8_t>(*at);
+    const char* field = at + 1;
+    step = TraceStep();
+    step.step = ++steps;
+    step.pc = current.getPc();
+    step.effects = tag;
+    if (tag & TraceFormat::kRegister) {
+        step.reg = static_cast<uint8_t>(field[0]);
+        step.value = get<uint64_t>(field + 1);
+        field += 9;
+        current.writeRegister(step.reg % InstructionSet::kRegisterCount, step.value);
+    }
+    if (tag & TraceFormat::kFlags) {
+        step.flags = static_cast<uint8_t>(*field++);
+        current.setFlags(step.flags);
+    }
+    if (tag & TraceFormat::kStore) {
+        step.address = get<uint64_t>(field);
+        step.stored = get<uint64_t>(field + 8);
+        field += 16;
+    }
+    if (tag & TraceFormat::kJump) {
+        current.setPc(get<uint64_t>(field));
+    } else if (tag & TraceFormat::kHalt) {
+        current.setHalted(true);
+    } else {
+        current.setPc(current.getPc() + InstructionSet::kInstructionBytes);
+    }
+    at += bytes;
+    // A snapshot after the step holds the state the next run started from
+    loadSnapshots();
+    return true;
+}
+
+void TraceReader::Cursor::loadSnapshots() {
+    // Mostly the state already decoded, but state may change between runs
+    while (size_t bytes = recordBytes(at, end)) {
+        if (static_cast<uint8_t>(*at) != TraceFormat::kSnapshotTag) {
+            return;
+        }
+        readSnapshot(at, current);
+        at += bytes;
+    }
+}
+
+void TraceReader::replayMemory(uint64_t step, SimulatedMemory& memory) const {
+    Cursor cursor(begin + snapshots.front().second, end, 0);
+    cursor.at += recordBytes(cursor.at, end);
+    TraceStep decoded;
+    while (cursor.position() < step && cursor.next(decoded)) {
+        if (decoded.effects & TraceFormat::kStore) {
+            memory.store64(decoded.address, decoded.stored);
+        }
+    }
+}
@@ -0,0 +1,312 @@
+#ifndef EXECUTION_TRACE_HPP
+#define EXECUTION_TRACE_HPP
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "instruction_set.hpp"
+#include "mapped_file.hpp"
+#include "processor_simulator.hpp"
+
+class SimulatedMemory;
+
+// Append-only binary execution traces.
+//
+// A trace stores what each executed instruction changed, plus a full
+// ProcessorState snapshot every `snapshotInterval` steps, so any step can be
+// reconstructed by decoding forward from the closest snapshot. A run that
+// starts from a state other than where the last one ended, for example after
+// restore(), also begins with a snapshot. Values are stored in host byte
+// order.
+//
+//   header    "PSTRACE1", u32 version, u32 snapshot interval
+//   step      u8 effects, then for each effect bit in order:
+//               kRegister  u8 register, u64 new value
+//               kFlags     u8 new flags
+//               kStore     u64 address, u64 value
+//               kJump      u64 new PC (without it the PC moved to the next
+//                          instruction, or stayed put on HALT)
+//               kHalt      (no payload)
+//   snapshot  u8 0x80, u64 step, u64 PC, u8 flags, u8 halted,
+//             u16 written-register mask, u64 per written register
+//   index     u8 0xFE, u64 step count, u64 snapshot count,
+//             (u64 step, u64 file offset) per snapshot
+//   footer    u64 file offset of the index, "PSTRIDX1"
+//
+// The index and footer are written by close(). A trace without them (e.g.
+// after a crash) is still readable; the reader then scans it once.
+struct TraceFormat {
+    static constexpr char kMagic[8] = {'P', 'S', 'T', 'R', 'A', 'C', 'E', '1'};
+    static constexpr char kIndexMagic[8] = {'P', 'S', 'T', 'R', 'I', 'D', 'X', '1'};
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 16;
+    static constexpr size_t kFooterBytes = 16;
+
+    // Effect bits of a step record
+    static constexpr uint8_t kRegister = 1 << 0;
+    static constexpr uint8_t kFlags = 1 << 1;
+    static constexpr uint8_t kStore = 1 << 2;
+    static constexpr uint8_t kJump = 1 << 3;
+    static constexpr uint8_t kHalt = 1 << 4;
+
+    static constexpr uint8_t kSnapshotTag = 0x80;
+    static constexpr uint8_t kIndexTag = 0xFE;
+
+    // Effect bits recorded for each opcode
+    static constexpr uint8_t effectsOf(Opcode op) {
+        switch (op) {
+            case Opcode::LI: case Opcode::MOV: case Opcode::ADD: case Opcode::SUB:
+            case Opcode::AND: case Opcode::OR: case Opcode::XOR: case Opcode::SHL:
+            case Opcode::SHR: case Opcode::MUL: case Opcode::ADDI: case Opcode::LOAD:
+                return kRegister;
+            case Opcode::CMP: case Opcode::CMPI:
+                return kFlags;
+            case Opcode::STORE:
+                return kStore;
+            case Opcode::JMP: case Opcode::BEQ: case Opcode::BNE: case Opcode::BLT:
+            case Opcode::BGE: case Opcode::BLTU: case Opcode::BGEU:
+                return kJump;
+            case Opcode::HALT:
+                return kHalt;
+            default:
+                return 0;
+        }
+    }
+
+    template <size_t... Ops>
+    static constexpr std::array<uint8_t, sizeof...(Ops)> effectsTable(std::index_sequence<Ops...>) {
+        return {effectsOf(static_cast<Opcode>(Ops))...};
+    }
+};
+
+// Records steps into a trace file.
+//
+// recordStep() encodes into an in-memory block; full blocks are handed to a
+// background thread that writes them out, so the interpreter only pays for
+// the encoding. If the writer falls more than kMaxQueuedBlocks behind,
+// recording waits for it.
+class TraceWriter {
+public:
+    using State = ProcessorSimulator::ProcessorState;
+
+    static constexpr uint32_t kDefaultSnapshotInterval = 4096;
+    static constexpr size_t kBlockBytes = 1 << 20;
+    static constexpr size_t kMaxQueuedBlocks = 4;
+
+    explicit TraceWriter(const std::string& path, uint32_t snapshotInterval = kDefaultSnapshotInterval);
+    ~TraceWriter();
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    // Records the state a run starts from: the initial state, or a snapshot
+    // if it differs from where the last run ended (after restore(),
+    // loadProgram(), register writes and the like)
+    void begin(const State& state);
+
+    // Notes the state a run ended in, for the next begin()
+    void end(const State& state) { last = RecordedState::of(state); }
+
+    // Records the effects of `instruction`, which has just executed at `previousPc`
+    void recordStep(const State& state, const Instruction& instruction, uint64_t previousPc) {
+        encodeStep(kOpcodeEffects[static_cast<size_t>(instruction.op)], state, instruction, previousPc);
+    }
+
+    // As recordStep(), for an instruction whose opcode is known at compile
+    // time, so the encoding has no branches on the effects
+    template <Opcode Op>
+    void recordStep(const State& state, const Instruction& instruction, uint64_t previousPc) {
+        encodeStep(TraceFormat::effectsOf(Op), state, instruction, previousPc);
+    }
+
+    uint64_t stepCount() const { return steps; }
+
+    // Writes the index, waits for the background writer and closes the file;
+    // throws ProcessorSimulatorException if any write failed
+    void close();
+
+private:
+    // A STORE step, and a snapshot with every register written
+    static constexpr size_t kMaxStepBytes = 1 + 8 + 8;
+    static constexpr size_t kMaxSnapshotBytes = 1 + 8 + 8 + 1 + 1 + 2 + 8 * InstructionSet::kRegisterCount;
+    static constexpr size_t kMaxRecordBytes = kMaxStepBytes + kMaxSnapshotBytes;
+
+    static constexpr std::array<uint8_t, InstructionSet::kOpcodeCount> kOpcodeEffects =
+        TraceFormat::effectsTable(std::make_index_sequence<InstructionSet::kOpcodeCount>());
+
+    void put(uint64_t value) {
+        std::memcpy(cursor, &value, sizeof(value));
+        cursor += sizeof(value);
+    }
+
+    void encodeStep(uint8_t effects, const State& state, const Instruction& instruction, uint64_t previousPc) {
+        if (static_cast<size_t>(blockEnd - cursor) < kMaxRecordBytes) {
+            rotate();
+        }
+
+        char* tag = cursor++;
+        if (effects & TraceFormat::kRegister) {
+            *cursor++ = static_cast<char>(instruction.rd);
+            put(state.readRegister(instruction.rd));
+        }
+        if (effects & TraceFormat::kFlags) {
+            *cursor++ = static_cast<char>(state.getFlags());
+        }
+        if (effects & TraceFormat::kStore) {
+            put(state.readRegister(instruction.rs1) + static_cast<uint64_t>(static_cast<int64_t>(instruction.imm)));
+            put(state.readRegister(instruction.rs2));
+        }
+        if (effects & TraceFormat::kJump) {
+            // Branch-free: the PC is always written, and kept only if the branch was taken
+            uint64_t pc = state.getPc();
+            bool taken = pc != previousPc + InstructionSet::kInstructionBytes;
+            put(pc);
+            cursor -= taken ? 0 : sizeof(uint64_t);
+            effects &= static_cast<uint8_t>(taken ? 0xFF : ~TraceFormat::kJump);
+        }
+        *tag = static_cast<char>(effects);
+
+        ++steps;
+        if (--untilSnapshot == 0) {
+            untilSnapshot = interval;
+            snapshot(state);
+        }
+    }
+
+    // The parts of a State that a snapshot records
+    struct RecordedState {
+        uint64_t pc = 0;
+        uint8_t flags = 0;
+        bool halted = false;
+        uint16_t writtenMask = 0;
+        std::array<uint64_t, InstructionSet::kRegisterCount> registers{};
+
+        static RecordedState of(const State& state);
+        bool operator==(const RecordedState& other) const;
+    };
+
+    void snapshot(const State& state);
+
+    // Queues the current block and starts a new one
+    void rotate();
+    void writerLoop();
+
+    struct Block {
+        std::vector<char> data;
+        size_t size;
+    };
+
+    std::string path;
+    std::FILE* file;
+    uint32_t interval;
+    uint32_t untilSnapshot;  // Steps left before the next snapshot
+    uint64_t steps = 0;
+    bool closed = false;
+
+    std::vector<char> block;
+    char* cursor;
+    char* blockEnd;
+    uint64_t blockOffset = TraceFormat::kHeaderBytes;  // File offset of the current block
+    std::vector<std::pair<uint64_t, uint64_t>> snapshots;  // (step, file offset)
+    RecordedState last;  // Where the last traced run ended
+
+    // Hand-off to the background writer
+    std::mutex mutex;
+    std::condition_variable blockQueued;
+    std::condition_variable blockWritten;
+    std::deque<Block> queue;
+    std::vector<std::vector<char>> spareBlocks;
+    bool stopping = false;
+    bool writeFailed = false;
+    std::thread writer;
+};
+
+// One decoded step of a trace
+struct TraceStep {
+    uint64_t step = 0;  // 1 for the first instruction executed
+    uint64_t pc = 0;    // Address of the instruction
+    uint8_t effects = 0;
+    uint8_t reg = 0;
+    uint64_t value = 0;
+    uint8_t flags = 0;
+    uint64_t address = 0;
+    uint64_t stored = 0;
+};
+
+// Memory-mapped, random-access view of a trace file
+class TraceReader {
+public:
+    using State = ProcessorSimulator::ProcessorState;
+
+    // Throws ProcessorSimulatorException if the file is not a trace
+    explicit TraceReader(const std::string& path);
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    // Sequential decoder over the steps that follow a position in the trace
+    class Cursor {
+    public:
+        // Decodes the next step and applies it to state(); false at the end
+        bool next(TraceStep& step);
+
+        // State after the last decoded step
+        const State& state() const { return current; }
+        uint64_t position() const { return steps; }
+
+    private:
+        friend class TraceReader;
+
+        Cursor(const char* at, const char* end, uint64_t steps)
+            : at(at), end(end), steps(steps) {}
+
+        // Applies the snapshots at the current position, if any
+        void loadSnapshots();
+
+        const char* at;
+        const char* end;
+        uint64_t steps;
+        State current;
+    };
+
+    uint64_t stepCount() const { return steps; }
+    uint32_t snapshotInterval() const { return interval; }
+
+    // A cursor whose state() is the state after `step` steps (0 = initial)
+    Cursor seek(uint64_t step) const;
+
+    State stateAt(uint64_t step) const { return seek(step).state(); }
+
+    // Applies the stores of the first `step` steps to `memory`, which should
+    // hold the memory image the traced run started from. Memory changed
+    // between traced runs, such as by restore(), is not in the trace.
+    void replayMemory(uint64_t step, SimulatedMemory& memory) const;
+
+private:
+    // Size of the record at `at`, or 0 if it is truncated or not a step or snapshot
+    static size_t recordBytes(const char* at, const char* end);
+
+    // Reads the snapshot at `at` into `state`; returns the step it was taken at
+    static uint64_t readSnapshot(const char* at, State& state);
+
+    bool readIndex();
+    void scan();
+
+    MappedFile file;
+    const char* begin;
+    const char* end;
+    uint32_t interval = 0;
+    uint64_t steps = 0;
+    std::vector<std::pair<uint64_t, uint64_t>> snapshots;  // (step, file offset)
+};
+
+#endif // EXECUTION_TRACE_HPP
@@ -0,0 +1,145 @@
+#include <fcgiapp.h>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "async_logger.hpp"
+#include "conversion_response.hpp"
+#include "json_request_parser.hpp"
+#include "result_cache.hpp"
+
+// FastCGI front end for POST /convert, for running behind nginx.
+//
+// Worker threads each accept and answer requests with FCGX_Accept_r, reusing
+// their own parser and body buffers, and share one result cache. Requests are
+// parsed and answered exactly like the HTTP server's /convert.
+//
+//   PROCESSOR_FCGI_SOCKET   ":9000" or a socket path; default: inherited on stdin (spawn-fcgi)
+//   PROCESSOR_FCGI_THREADS  worker threads; default: hardware concurrency
+//   PROCESSOR_CACHE_BYTES   result cache budget, as for processor_server
+class FcgiServer {
+private:
+    static constexpr size_t kMaxBodyBytes = 16 * 1024 * 1024;
+    static constexpr size_t kDefaultCacheBytes = 64 * 1024 * 1024;
+    static constexpr int kListenBacklog = 1024;
+
+    static constexpr const char* kJsonHeaders = "Content-Type: application/json\r\n\r\n";
+
+    static size_t cacheBudgetFromEnvironment() {
+        const char* bytes = std::getenv("PROCESSOR_CACHE_BYTES");
+        return bytes != nullptr ? static_cast<size_t>(std::strtoull(bytes, nullptr, 10)) : kDefaultCacheBytes;
+    }
+
+    static unsigned threadsFromEnvironment() {
+        const char* threads = std::getenv("PROCESSOR_FCGI_THREADS");
+        unsigned count = threads != nullptr ? static_cast<unsigned>(std::strtoul(threads, nullptr, 10))
+                                            : std::thread::hardware_concurrency();
+        return count > 0 ? count : 1;
+    }
+
+    // Level comes from PROCESSOR_LOG_LEVEL, as for processor_server
+    static LogLevel logLevelFromEnvironment() {
+        const char* level = std::getenv("PROCESSOR_LOG_LEVEL");
+        return level != nullptr ? parseLogLevel(level) : LogLevel::INFO;
+    }
+
+    ConversionResultCache cache{cacheBudgetFromEnvironment()};
+    AsyncLogger logger{std::clog, logLevelFromEnvironment()};
+    int listenSocket = 0;  // 0: the socket spawn-fcgi passes on stdin
+
+    // Some platforms need accept() on a shared socket serialised
+    std::mutex acceptMutex;
+
+    // Scratch reused across the requests of one worker
+    struct Worker {
+        JsonRequestParser parser;
+        std::string body;
+        std::string response;
+    };
+
+    static void respond(FCGX_Request& request, const char* status, const std::string& body) {
+        if (status != nullptr) {
+            FCGX_FPrintF(request.out, "Status: %s\r\n", status);
+        }
+        FCGX_PutS(kJsonHeaders, request.out);
+        FCGX_PutStr(body.data(), static_cast<int>(body.size()), request.out);
+    }
+
+    void handle(FCGX_Request& request, Worker& worker) {
+        const char* contentLength = FCGX_GetParam("CONTENT_LENGTH", request.envp);
+        unsigned long long length = contentLength != nullptr ? std::strtoull(contentLength, nullptr, 10) : 0;
+        if (length > kMaxBodyBytes) {
+            ConversionResponse::writeError("Request body exceeds " + std::to_string(kMaxBodyBytes) + " bytes",
+                                           worker.response);
+            respond(request, "413 Payload Too Large", worker.response);
+            return;
+        }
+
+        worker.body.resize(static_cast<size_t>(length));
+        int read = length > 0 ? FCGX_GetStr(&worker.body[0], static_cast<int>(length), request.in) : 0;
+        worker.body.resize(static_cast<size_t>(read > 0 ? read : 0));
+
+        ConversionRequestFields fields;
+        if (!worker.parser.parseRequest(worker.body, fields)) {
+            ConversionResponse::writeError(worker.parser.error(), worker.response);
+            respond(request, "400 Bad Request", worker.response);
+            return;
+        }
+        ConversionResponse::write(fields.binary, ConversionResponse::parseMode(fields.mode), &cache,
+                                  worker.response);
+        respond(request, nullptr, worker.response);
+    }
+
+    void workerLoop() {
+        Worker worker;
+        FCGX_Request request;
+        FCGX_InitRequest(&request, listenSocket, 0);
+        while (true) {
+            int accepted;
+            {
+                std::lock_guard<std::mutex> lock(acceptMutex);
+                accepted = FCGX_Accept_r(&request);
+            }
+            if (accepted < 0) {
+                break;
+            }
+            handle(request, worker);
+            FCGX_Finish_r(&request);
+        }
+    }
+
+public:
+    int run() {
+        if (FCGX_Init() != 0) {
+            std::cerr << "Failed to initialise FastCGI" << std::endl;
+            return 1;
+        }
+        const char* socketPath = std::getenv("PROCESSOR_FCGI_SOCKET");
+        if (socketPath != nullptr) {
+            listenSocket = FCGX_OpenSocket(socketPath, kListenBacklog);
+            if (listenSocket < 0) {
+                std::cerr << "Failed to open FastCGI socket " << socketPath << std::endl;
+                return 1;
+            }
+        }
+
+        unsigned threads = threadsFromEnvironment();
+        logger.log(LogLevel::INFO, "listening", {{"socket", socketPath != nullptr ? socketPath : "stdin"},
+                                                 {"threads", threads}});
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < threads; ++i) {
+            workers.emplace_back(&FcgiServer::workerLoop, this);
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        return 0;
+    }
+};
+
+int main() {
+    FcgiServer server;
+    return server.run();
+}
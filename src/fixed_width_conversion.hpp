@@ -0,0 +1,134 @@
+#ifndef FIXED_WIDTH_CONVERSION_HPP
+#define FIXED_WIDTH_CONVERSION_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include "processor_simulator.hpp"
+
+// Conversion kernels specialised at compile time on mode and register width.
+//
+// With Width fixed at 8, 16, 32 or 64 bits every loop has a constant trip
+// count and the mode is resolved by `if constexpr`, so each instantiation
+// compiles to straight-line code. STANDARD and UNSIGNED print every digit.
+// SIGNED reads a two's-complement value: negative values are sign-extended
+// to 32 (or 64) bits, others lose their leading zeros. FLOATING_POINT reads
+// IEEE binary16/32/64 for widths 16/32/64 and zero-extends 8-bit inputs to
+// binary32.
+//
+// Callers that already hold the value (register dumps, the interpreter) use
+// format(); text input goes through convert(), which packs eight ASCII bits
+// per step like the engine's scalar kernel.
+template <ConversionMode Mode, size_t Width>
+class FixedWidthConverter {
+public:
+    static_assert(Width == 8 || Width == 16 || Width == 32 || Width == 64,
+                  "fixed-width kernels exist for 8, 16, 32 and 64 bits");
+
+    static constexpr bool kFloatingPoint = Mode == ConversionMode::FLOATING_POINT;
+
+    // Upper bound of the output length, e.g. "-1.797693E+308"
+    static constexpr size_t kMaxOutputLength = kFloatingPoint ? 16
+        : Mode == ConversionMode::SIGNED ? (Width <= 32 ? 8 : 16) : Width / 4;
+
+    // Writes the conversion of the low Width bits of `value`; returns its length
+    static size_t format(uint64_t value, char* out) {
+        if constexpr (Width < 64) {
+            value &= (uint64_t{1} << Width) - 1;
+        }
+
+        if constexpr (kFloatingPoint) {
+            return formatReal(toReal(value), out);
+        } else if constexpr (Mode == ConversionMode::SIGNED) {
+            if ((value >> (Width - 1)) != 0) {
+                // Negative: print the sign-extended value at int32/int64 width
+                if constexpr (Width <= 32) {
+                    return formatDigits(value | ~uint64_t{0} << Width, 8, out);
+                } else {
+                    return formatDigits(value, 16, out);
+                }
+            }
+            size_t digits = 1;
+            for (uint64_t rest = value >> 4; rest != 0; rest >>= 4) {
+                ++digits;
+            }
+            return formatDigits(value, digits, out);
+        } else {
+            return formatDigits(value, Width / 4, out);
+        }
+    }
+
+    // Packs exactly Width ASCII bits, first character most significant.
+    // Returns false if any character is not '0' or '1'.
+    static bool parse(const char* bits, uint64_t& value) {
+        uint64_t packed = 0;
+        uint64_t invalid = 0;
+        for (size_t i = 0; i < Width / 8; ++i) {
+            uint64_t word;
+            std::memcpy(&word, bits + i * 8, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            word = __builtin_bswap64(word);
+#endif
+            invalid |= (word & 0xFEFEFEFEFEFEFEFEULL) ^ 0x3030303030303030ULL;
+            // Gather bit 0 of every byte into one byte, first character first
+            packed = packed << 8 | ((word & 0x0101010101010101ULL) * 0x8040201008040201ULL) >> 56;
+        }
+        value = packed;
+        return invalid == 0;
+    }
+
+    // Converts exactly Width ASCII bits; returns the output length, or 0 on invalid input
+    static size_t convert(const char* bits, char* out) {
+        uint64_t value;
+        return parse(bits, value) ? format(value, out) : 0;
+    }
+
+private:
+    // The low `digits` hex digits of `value`, most significant first
+    static size_t formatDigits(uint64_t value, size_t digits, char* out) {
+        static constexpr char kHexDigits[] = "0123456789ABCDEF";
+        for (size_t i = 0; i < digits; ++i) {
+            out[i] = kHexDigits[(value >> (4 * (digits - 1 - i))) & 0xF];
+        }
+        return digits;
+    }
+
+    static double toReal(uint64_t value) {
+        if constexpr (Width == 16) {
+            // binary16: 1 sign, 5 exponent and 10 fraction bits, exactly representable as double
+            auto exponent = static_cast<int>((value >> 10) & 0x1F);
+            auto fraction = static_cast<double>(value & 0x3FF);
+            double magnitude;
+            if (exponent == 0) {
+                magnitude = std::ldexp(fraction, -24);
+            } else if (exponent == 0x1F) {
+                magnitude = fraction == 0 ? std::numeric_limits<double>::infinity()
+                                          : std::numeric_limits<double>::quiet_NaN();
+            } else {
+                magnitude = std::ldexp(fraction + 1024.0, exponent - 25);
+            }
+            return (value >> 15) != 0 ? -magnitude : magnitude;
+        } else if constexpr (Width == 64) {
+            double real;
+            std::memcpy(&real, &value, sizeof(real));
+            return real;
+        } else {
+            auto word = static_cast<uint32_t>(value);
+            float real;
+            std::memcpy(&real, &word, sizeof(real));
+            return static_cast<double>(real);
+        }
+    }
+
+    static size_t formatReal(double real, char* out) {
+        char text[32];
+        int length = std::snprintf(text, sizeof(text), "%.6E", real);
+        std::memcpy(out, text, static_cast<size_t>(length));
+        return static_cast<size_t>(length);
+    }
+};
+
+#endif // FIXED_WIDTH_CONVERSION_HPP
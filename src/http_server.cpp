@@ -4,89 +4,482 @@
 #include <thread>
 #include <mutex>
 #include <vector>
-#include <regex>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
 #include <httplib.h>
+#include "async_logger.hpp"
+#include "conversion_engine.hpp"
+#include "conversion_response.hpp"
+#include "json_request_parser.hpp"
+#include "packed_bits.hpp"
 #include "processor_simulator.hpp"
+#include "request_arena.hpp"
+#include "result_cache.hpp"
+#include "server_metrics.hpp"
+#include "stream_converter.hpp"
+#include "thread_pool.hpp"
 
 class HttpServer {
 private:
-    std::string extractBinaryFromJson(const std::string& json) {
-        std::regex binaryRegex("\"binary\":\\s*\"([^\"]+)\"");
-        std::smatch match;
-        if (std::regex_search(json, match, binaryRegex)) {
-            return match[1].str();
+    // Limits for POST /convert/batch
+    static constexpr size_t kMaxBatchBodyBytes = 16 * 1024 * 1024;
+    static constexpr size_t kMaxBatchItems = 10000;
+
+    // Limits for POST /convert/stream; digits are sent in chunks of kStreamChunkBytes
+    static constexpr uint64_t kMaxStreamBodyBytes = uint64_t{4} << 30;
+    static constexpr size_t kStreamChunkBytes = 64 * 1024;
+
+    // Batches at least this large are converted across the thread pool
+    static constexpr size_t kParallelBatchItems = 64;
+
+    // Request bodies are only logged at debug level, cut to this many bytes
+    static constexpr size_t kLoggedBodyBytes = 64;
+
+    // Default memory budget of the result cache; PROCESSOR_CACHE_BYTES overrides it (0 disables)
+    static constexpr size_t kDefaultCacheBytes = 64 * 1024 * 1024;
+
+    ServerMetrics metrics;
+    ConversionResultCache cache{cacheBudgetFromEnvironment()};
+
+    static size_t cacheBudgetFromEnvironment() {
+        const char* bytes = std::getenv("PROCESSOR_CACHE_BYTES");
+        return bytes != nullptr ? static_cast<size_t>(std::strtoull(bytes, nullptr, 10)) : kDefaultCacheBytes;
+    }
+
+    // Level comes from PROCESSOR_LOG_LEVEL (debug, info, warning, error, off)
+    AsyncLogger logger{std::clog, logLevelFromEnvironment()};
+
+    static LogLevel logLevelFromEnvironment() {
+        const char* level = std::getenv("PROCESSOR_LOG_LEVEL");
+        return level != nullptr ? parseLogLevel(level) : LogLevel::INFO;
+    }
+
+    static long long elapsedMicros(std::chrono::steady_clock::time_point started) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count();
+    }
+
+    void logRequest(std::string_view path, std::string_view body, int status,
+                    std::string_view mode, size_t items, std::chrono::steady_clock::time_point started) {
+        logRequest(path, body.size(), body, status, mode, items, started);
+    }
+
+    // For bodies that were never held in memory: `bodyBytes` is their size and `body` what was kept
+    void logRequest(std::string_view path, uint64_t bodyBytes, std::string_view body, int status,
+                    std::string_view mode, size_t items, std::chrono::steady_clock::time_point started) {
+        LogLevel level = status >= 400 ? LogLevel::WARNING : LogLevel::INFO;
+        if (!logger.enabled(level)) {
+            return;
+        }
+        long long micros = elapsedMicros(started);
+        if (logger.enabled(LogLevel::DEBUG)) {
+            logger.log(level, "request", {{"path", path}, {"status", status}, {"mode", mode},
+                                          {"items", items}, {"body_bytes", bodyBytes},
+                                          {"duration_us", micros},
+                                          {"body", body.substr(0, kLoggedBodyBytes)}});
+        } else {
+            logger.log(level, "request", {{"path", path}, {"status", status}, {"mode", mode},
+                                          {"items", items}, {"body_bytes", bodyBytes},
+                                          {"duration_us", micros}});
         }
-        return "1010";  // Default value
     }
 
-    std::string extractModeFromJson(const std::string& json) {
-        std::regex modeRegex("\"mode\":\\s*\"([^\"]+)\"");
-        std::smatch match;
-        if (std::regex_search(json, match, modeRegex)) {
-            return match[1].str();
+    // One parser per worker thread, so its scratch space is reused across requests
+    static JsonRequestParser& requestParser() {
+        thread_local JsonRequestParser parser;
+        return parser;
+    }
+
+    static std::string errorJson(std::string_view message) {
+        std::string json;
+        ConversionResponse::writeError(message, json);
+        return json;
+    }
+
+    static ConversionMode parseMode(std::string_view mode) {
+        return ConversionResponse::parseMode(mode);
+    }
+
+    static constexpr std::string_view kHexPrefix = ConversionResponse::kHexPrefix;
+    static constexpr std::string_view kHexSuffix = ConversionResponse::kHexSuffix;
+
+    // Converts one request into `out`, which holds maxHexLength() characters,
+    // and returns the hex length; records the outcome and rethrows invalid input
+    size_t convertInto(std::string_view binary, ConversionMode mode, char* out, size_t capacity) {
+        ServerMetrics::RequestKind kind = ServerMetrics::kindOf(mode);
+        try {
+            size_t length = ConversionResponse::convert(binary, mode, &cache, out, capacity);
+            metrics.recordConversion(kind, ServerMetrics::Outcome::OK, binary.size());
+            return length;
+        } catch (const ProcessorSimulatorException&) {
+            metrics.recordConversion(kind, ServerMetrics::Outcome::INVALID_INPUT, binary.size());
+            throw;
         }
-        return "STANDARD";  // Default value
     }
 
-    std::string handleConversionRequest(const std::string& binary, const std::string& mode) {
-        ProcessorSimulator simulator;
-        ConversionMode conversionMode;
+    // Writes the JSON response for one conversion into `body`, reusing its capacity
+    void handleConversionRequest(std::string_view binary, std::string_view mode, std::string& body) {
+        ConversionMode conversionMode = parseMode(mode);
+        bool converted = ConversionResponse::write(binary, conversionMode, &cache, body);
+        metrics.recordConversion(ServerMetrics::kindOf(conversionMode),
+                                 converted ? ServerMetrics::Outcome::OK : ServerMetrics::Outcome::INVALID_INPUT,
+                                 binary.size());
+    }
 
-        // Convert string mode to enum
-        if (mode == "SIGNED") {
-            conversionMode = ConversionMode::SIGNED;
-        } else if (mode == "UNSIGNED") {
-            conversionMode = ConversionMode::UNSIGNED;
-        } else if (mode == "FLOATING_POINT") {
-            conversionMode = ConversionMode::FLOATING_POINT;
-        } else {
-            conversionMode = ConversionMode::STANDARD;
+    static bool isPackedRequest(const httplib::Request& req) {
+        return req.get_header_value("Content-Type").rfind("application/octet-stream", 0) == 0;
+    }
+
+    // Packed input: the body carries the bits MSB-first, eight per byte, and
+    // the optional "bits" query parameter drops padding from the last byte.
+    // Digit-wise modes convert straight from the packed words into `body`;
+    // the others expand to ASCII bits in the request arena first.
+    void handlePackedConversionRequest(const httplib::Request& req, ConversionMode mode, int& status,
+                                       std::string& body) {
+        ServerMetrics::RequestKind kind = ServerMetrics::kindOf(mode);
+        size_t bitCount = req.body.size() * 8;
+        if (req.has_param("bits")) {
+            std::string bits = req.get_param_value("bits");
+            char* end = nullptr;
+            unsigned long long requested = std::strtoull(bits.c_str(), &end, 10);
+            if (bits.empty() || *end != '\0' || requested > bitCount) {
+                status = 400;
+                metrics.recordConversion(ServerMetrics::RequestKind::UNKNOWN, ServerMetrics::Outcome::BAD_REQUEST, 0);
+                body = errorJson("Invalid bits parameter: must not exceed 8 times the body size");
+                return;
+            }
+            bitCount = static_cast<size_t>(requested);
         }
 
+        status = 200;
+        RequestArena::Scope arena;
+        std::pmr::vector<uint64_t> words(PackedBits::wordCount(bitCount), arena.resource());
+        PackedBits::packBytes(reinterpret_cast<const unsigned char*>(req.body.data()), bitCount, words.data());
         try {
-            std::string hexResult = ProcessorSimulator::binaryToHex(binary, conversionMode);
-            return "{\"hex\": \"" + hexResult + "\"}";
+            if (mode == ConversionMode::STANDARD || mode == ConversionMode::UNSIGNED) {
+                size_t digits = ConversionEngine::hexLength(bitCount);
+                body.assign(kHexPrefix);
+                body.resize(kHexPrefix.size() + digits);
+                PackedBits::toHex(words.data(), bitCount, &body[kHexPrefix.size()]);
+            } else {
+                std::pmr::vector<char> ascii(bitCount, arena.resource());
+                PackedBits::unpackAscii(words.data(), bitCount, ascii.data());
+                size_t capacity = ProcessorSimulator::maxHexLength(bitCount, mode);
+                body.assign(kHexPrefix);
+                body.resize(kHexPrefix.size() + capacity);
+                size_t length = ProcessorSimulator::binaryToHex(std::string_view(ascii.data(), bitCount), mode,
+                                                                &body[kHexPrefix.size()], capacity);
+                body.resize(kHexPrefix.size() + length);
+            }
+            body += kHexSuffix;
+            metrics.recordConversion(kind, ServerMetrics::Outcome::OK, bitCount);
         } catch (const ProcessorSimulatorException& e) {
-            return "{\"error\": \"" + std::string(e.what()) + "\"}";
+            metrics.recordConversion(kind, ServerMetrics::Outcome::INVALID_INPUT, bitCount);
+            body = errorJson(e.what());
         }
     }
 
+    // Reads a batch body of at most kMaxBatchBodyBytes into `body`; false if
+    // it is larger, judged by Content-Length or, for chunked uploads, while reading
+    static bool readBatchBody(const httplib::Request& req, const httplib::ContentReader& content,
+                              std::string& body) {
+        if (req.has_header("Content-Length")) {
+            unsigned long long length = std::strtoull(req.get_header_value("Content-Length").c_str(), nullptr, 10);
+            if (length > kMaxBatchBodyBytes) {
+                return false;
+            }
+            body.reserve(static_cast<size_t>(length));
+        }
+        bool fits = true;
+        content([&](const char* data, size_t length) {
+            if (body.size() + length > kMaxBatchBodyBytes) {
+                fits = false;
+                return false;
+            }
+            body.append(data, length);
+            return true;
+        });
+        return fits;
+    }
+
+    // Convert every {"binary", "mode"} object of the "items" array, in order.
+    //
+    // The items and every item's hex digits live in the request arena: each
+    // item gets a maxHexLength() slice of one buffer, so workers converting
+    // in parallel never allocate, and the response is assembled in one pass.
+    std::string handleBatchRequest(const std::string& json, int& status, size_t& itemCount) {
+        RequestArena::Scope arena;
+        JsonRequestParser& parser = requestParser();
+        std::pmr::vector<ConversionRequestFields> items(arena.resource());
+        if (!parser.parseBatch(json, items, kMaxBatchItems)) {
+            status = parser.tooManyItems() ? 413 : 400;
+            metrics.recordConversion(ServerMetrics::RequestKind::UNKNOWN, ServerMetrics::Outcome::BAD_REQUEST, 0);
+            return errorJson(parser.error());
+        }
+        itemCount = items.size();
+
+        std::pmr::vector<ConversionMode> modes(items.size(), arena.resource());
+        std::pmr::vector<size_t> offsets(items.size() + 1, 0, arena.resource());
+        for (size_t i = 0; i < items.size(); ++i) {
+            modes[i] = parseMode(items[i].mode);
+            offsets[i + 1] = offsets[i] + ProcessorSimulator::maxHexLength(items[i].binary.size(), modes[i]);
+        }
+        auto* hex = static_cast<char*>(arena.resource()->allocate(offsets.back(), 1));
+        std::pmr::vector<size_t> lengths(items.size(), 0, arena.resource());
+        // Failures are rare, so their messages use ordinary strings
+        std::pmr::vector<std::string> errors(items.size(), arena.resource());
+
+        auto convertRange = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                try {
+                    lengths[i] = convertInto(items[i].binary, modes[i], hex + offsets[i],
+                                             offsets[i + 1] - offsets[i]);
+                } catch (const ProcessorSimulatorException& e) {
+                    errors[i] = e.what();
+                }
+            }
+        };
+        if (items.size() >= kParallelBatchItems) {
+            ThreadPool::shared().parallelFor(items.size(), kParallelBatchItems / 4, convertRange);
+        } else {
+            convertRange(0, items.size());
+        }
+
+        size_t responseBytes = 16;
+        for (size_t i = 0; i < items.size(); ++i) {
+            responseBytes += kHexPrefix.size() + lengths[i] + kHexSuffix.size() + errors[i].size() + 2;
+        }
+        std::string response;
+        response.reserve(responseBytes);
+        response += "{\"results\": [";
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i > 0) {
+                response += ", ";
+            }
+            if (errors[i].empty()) {
+                response += kHexPrefix;
+                response.append(hex + offsets[i], lengths[i]);
+                response += kHexSuffix;
+            } else {
+                response += "{\"error\": \"";
+                appendJsonEscaped(response, errors[i]);
+                response += "\"}";
+            }
+        }
+        response += "]}";
+        status = 200;
+        return response;
+    }
+
+    // Raw bits in, hex digits out, for inputs too large to buffer.
+    //
+    // The response starts as soon as the request is accepted: the chunked
+    // content provider reads the body itself, through a copy of the content
+    // reader, which stays bound to the connection after the handler returns.
+    // Each block of digits is written as soon as it is complete, and writing
+    // paces reading, so memory per request is one block whatever the input
+    // size. Clients must read the response while they upload; one that does
+    // not stalls the upload until the write times out.
+    //
+    // Invalid input found mid-stream cannot become a 400, since the status
+    // line is already out: the connection is dropped without the final
+    // chunk. A bad mode or an oversized Content-Length is still refused
+    // up front.
+    //
+    // With a Content-Length the digits match /convert; see StreamingHexConverter
+    // for chunked uploads. Only the digit-wise modes, STANDARD and UNSIGNED, stream.
+    //
+    // A request is still in flight after the handler returns: its latency
+    // and log line are recorded once the response is over.
+    void handleStreamRequest(const httplib::Request& req, httplib::Response& res,
+                             const httplib::ContentReader& content, const std::string& mode,
+                             std::chrono::steady_clock::time_point started) {
+        auto inFlight = std::make_shared<ServerMetrics::InFlight>(metrics);
+        int& status = res.status;
+        ConversionMode conversionMode = parseMode(mode);
+        if (conversionMode != ConversionMode::STANDARD && conversionMode != ConversionMode::UNSIGNED) {
+            status = 400;
+            metrics.recordConversion(ServerMetrics::RequestKind::UNKNOWN, ServerMetrics::Outcome::BAD_REQUEST, 0);
+            res.set_content(errorJson("Only STANDARD and UNSIGNED conversions can be streamed"), "application/json");
+            finishStreamRequest(status, mode, 0, started);
+            return;
+        }
+
+        uint64_t declared = 0;
+        bool hasLength = req.has_header("Content-Length");
+        if (hasLength) {
+            declared = std::strtoull(req.get_header_value("Content-Length").c_str(), nullptr, 10);
+        }
+        if (declared > kMaxStreamBodyBytes) {
+            status = 413;
+            metrics.recordConversion(ServerMetrics::RequestKind::UNKNOWN, ServerMetrics::Outcome::BAD_REQUEST, 0);
+            res.set_content(errorJson("Request body exceeds " + std::to_string(kMaxStreamBodyBytes) + " bytes"),
+                            "application/json");
+            finishStreamRequest(status, mode, 0, started);
+            return;
+        }
+
+        // Shared by the provider and the release callback, which both outlive the handler
+        struct Stream {
+            httplib::ContentReader content;
+            int status = 400;  // Until the whole body has been converted
+            uint64_t bits = 0;
+        };
+        auto stream = std::make_shared<Stream>(Stream{content});
+        ServerMetrics::RequestKind kind = ServerMetrics::kindOf(conversionMode);
+
+        status = 200;
+        res.set_chunked_content_provider("text/plain",
+            [this, stream, kind, hasLength, declared](size_t, httplib::DataSink& sink) {
+                StreamingHexConverter converter([&](const char* data, size_t length) {
+                    if (!sink.write(data, length)) {
+                        throw ProcessorSimulatorException("Client stopped reading the response");
+                    }
+                }, kStreamChunkBytes);
+                if (hasLength) {
+                    converter.setTotalBits(declared);
+                }
+
+                StreamOutcome outcome = convertStream(converter, [&](const BodyReceiver& receiver) {
+                    return stream->content(receiver);
+                }, kMaxStreamBodyBytes);
+                stream->bits = converter.bitsConsumed();
+                if (!outcome.error.empty()) {
+                    stream->status = outcome.tooLarge ? 413 : 400;
+                    metrics.recordConversion(kind, ServerMetrics::Outcome::INVALID_INPUT, stream->bits);
+                    return false;  // Drops the connection; the status line is already out
+                }
+                stream->status = 200;
+                metrics.recordConversion(kind, ServerMetrics::Outcome::OK, stream->bits);
+                sink.done();
+                return true;
+            },
+            [this, inFlight, stream, mode, started](bool) mutable {
+                // Called once the response is over, whether or not it was complete
+                inFlight.reset();
+                finishStreamRequest(stream->status, mode, stream->bits, started);
+            });
+    }
+
+    void finishStreamRequest(int status, std::string_view mode, uint64_t bodyBytes,
+                             std::chrono::steady_clock::time_point started) {
+        metrics.recordLatency(status == 200 ? ServerMetrics::kindOf(parseMode(mode))
+                                            : ServerMetrics::RequestKind::UNKNOWN,
+                              std::chrono::steady_clock::now() - started);
+        logRequest("/convert/stream", bodyBytes, {}, status, mode, 1, started);
+    }
+
+    static void setCorsHeaders(httplib::Response& res) {
+        res.set_header("Access-Control-Allow-Origin", "*");
+        res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type");
+    }
+
 public:
     void start(int port = 8081) {  // Changed default port
         httplib::Server svr;
 
         // Handle OPTIONS request for CORS preflight
-        svr.Options("/convert", [](const httplib::Request& req, httplib::Response& res) {
-            res.set_header("Access-Control-Allow-Origin", "*");
-            res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
-            res.set_header("Access-Control-Allow-Headers", "Content-Type");
+        auto preflight = [](const httplib::Request&, httplib::Response& res) {
+            setCorsHeaders(res);
             res.status = 204;
-        });
+        };
+        svr.Options("/convert", preflight);
+        svr.Options("/convert/batch", preflight);
+        svr.Options("/convert/stream", preflight);
 
         // Handle POST request for conversion
         svr.Post("/convert", [this](const httplib::Request& req, httplib::Response& res) {
+            auto started = std::chrono::steady_clock::now();
+            ServerMetrics::InFlight inFlight(metrics);
+
             // Set CORS headers
-            res.set_header("Access-Control-Allow-Origin", "*");
-            res.set_header("Access-Control-Allow-Methods", "POST, OPTIONS");
-            res.set_header("Access-Control-Allow-Headers", "Content-Type");
+            setCorsHeaders(res);
             res.set_header("Content-Type", "application/json");
 
-            // Log incoming request body for debugging
-            std::cout << "Received request body: " << req.body << std::endl;
+            if (isPackedRequest(req)) {
+                std::string mode = req.has_param("mode") ? req.get_param_value("mode") : "STANDARD";
+                handlePackedConversionRequest(req, parseMode(mode), res.status, res.body);
+                metrics.recordLatency(res.status == 200 ? ServerMetrics::kindOf(parseMode(mode))
+                                                        : ServerMetrics::RequestKind::UNKNOWN,
+                                      std::chrono::steady_clock::now() - started);
+                logRequest("/convert", req.body, res.status, mode, 1, started);
+                return;
+            }
 
             // Parse JSON body
-            std::string binary = extractBinaryFromJson(req.body);
-            std::string mode = extractModeFromJson(req.body);
+            JsonRequestParser& parser = requestParser();
+            ConversionRequestFields request;
+            if (!parser.parseRequest(req.body, request)) {
+                res.body = errorJson(parser.error());
+                res.status = 400;
+                metrics.recordConversion(ServerMetrics::RequestKind::UNKNOWN, ServerMetrics::Outcome::BAD_REQUEST, 0);
+                metrics.recordLatency(ServerMetrics::RequestKind::UNKNOWN, std::chrono::steady_clock::now() - started);
+                logRequest("/convert", req.body, res.status, {}, 0, started);
+                return;
+            }
 
-            // Perform conversion
-            std::string result = handleConversionRequest(binary, mode);
-
-            // Set response
-            res.body = result;
+            // Perform conversion straight into the response
+            handleConversionRequest(request.binary, request.mode, res.body);
             res.status = 200;
+            metrics.recordLatency(ServerMetrics::kindOf(parseMode(request.mode)),
+                                  std::chrono::steady_clock::now() - started);
+            logRequest("/convert", req.body, res.status, request.mode, 1, started);
+        });
+
+        // Handle POST request for batch conversion
+        svr.Post("/convert/batch", [this](const httplib::Request& req, httplib::Response& res,
+                                          const httplib::ContentReader& content) {
+            auto started = std::chrono::steady_clock::now();
+            ServerMetrics::InFlight inFlight(metrics);
+
+            setCorsHeaders(res);
+            res.set_header("Content-Type", "application/json");
+
+            // The body is read here, so an oversized one is refused before it is buffered
+            std::string body;
+            if (!readBatchBody(req, content, body)) {
+                res.body = errorJson("Batch body exceeds " + std::to_string(kMaxBatchBodyBytes) + " bytes");
+                res.status = 413;
+                res.set_header("Connection", "close");  // The rest of the body is never read
+                metrics.recordConversion(ServerMetrics::RequestKind::UNKNOWN, ServerMetrics::Outcome::BAD_REQUEST, 0);
+                metrics.recordLatency(ServerMetrics::RequestKind::BATCH, std::chrono::steady_clock::now() - started);
+                logRequest("/convert/batch", {}, res.status, {}, 0, started);
+                return;
+            }
+
+            size_t items = 0;
+            res.body = handleBatchRequest(body, res.status, items);
+            metrics.recordLatency(ServerMetrics::RequestKind::BATCH, std::chrono::steady_clock::now() - started);
+            logRequest("/convert/batch", body, res.status, "batch", items, started);
+        });
+
+        // Handle POST request for streamed conversion of large inputs
+        svr.Post("/convert/stream", [this](const httplib::Request& req, httplib::Response& res,
+                                           const httplib::ContentReader& content) {
+            auto started = std::chrono::steady_clock::now();
+            setCorsHeaders(res);
+
+            std::string mode = req.has_param("mode") ? req.get_param_value("mode") : "STANDARD";
+            handleStreamRequest(req, res, content, mode, started);
+        });
+
+        // Prometheus scrape endpoint
+        svr.Get("/metrics", [this](const httplib::Request&, httplib::Response& res) {
+            ServerMetrics::Gauges gauges;
+            gauges.threadPoolQueueDepth = ThreadPool::shared().queueDepth();
+            gauges.threadPoolThreads = ThreadPool::shared().threadCount();
+            gauges.cacheHits = cache.hits();
+            gauges.cacheMisses = cache.misses();
+            gauges.cacheBytes = cache.memoryUsage();
+            gauges.cacheEntries = cache.entryCount();
+            res.set_content(metrics.renderPrometheus(gauges), "text/plain; version=0.0.4");
         });
 
-        std::cout << "Server attempting to listen on port " << port << std::endl;
+        logger.log(LogLevel::INFO, "listening", {{"port", port}});
         
         // Bind to all interfaces
         if (!svr.listen("0.0.0.0", port)) {
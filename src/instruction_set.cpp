@@ -0,0 +1,430 @@
+#include "instruction_set.hpp"
+#include "processor_simulator.hpp"
+
+#include <cctype>
+#include <limits>
+
+namespace {
+
+// Operand layout of each opcode in assembly text
+enum class Format {
+    NONE,         // HALT, SYNC
+    REG_IMM,      // LI rd, imm
+    REG_REG,      // MOV rd, rs1
+    REG_REG_REG,  // ADD rd, rs1, rs2
+    REG_REG_IMM,  // ADDI rd, rs1, imm
+    LOAD,         // LOAD rd, imm(rs1)
+    STORE,        // STORE rs2, imm(rs1)
+    COMPARE,      // CMP rs1, rs2
+    COMPARE_IMM,  // CMPI rs1, imm
+    TARGET        // JMP target
+};
+
+struct OpcodeInfo {
+    const char* name;
+    Format format;
+};
+
+const OpcodeInfo kOpcodes[InstructionSet::kOpcodeCount] = {
+    {"NOP", Format::NONE},
+    {"HALT", Format::NONE},
+    {"LI", Format::REG_IMM},
+    {"MOV", Format::REG_REG},
+    {"ADD", Format::REG_REG_REG},
+    {"SUB", Format::REG_REG_REG},
+    {"AND", Format::REG_REG_REG},
+    {"OR", Format::REG_REG_REG},
+    {"XOR", Format::REG_REG_REG},
+    {"SHL", Format::REG_REG_REG},
+    {"SHR", Format::REG_REG_REG},
+    {"MUL", Format::REG_REG_REG},
+    {"ADDI", Format::REG_REG_IMM},
+    {"LOAD", Format::LOAD},
+    {"STORE", Format::STORE},
+    {"CMP", Format::COMPARE},
+    {"CMPI", Format::COMPARE_IMM},
+    {"JMP", Format::TARGET},
+    {"BEQ", Format::TARGET},
+    {"BNE", Format::TARGET},
+    {"BLT", Format::TARGET},
+    {"BGE", Format::TARGET},
+    {"BLTU", Format::TARGET},
+    {"BGEU", Format::TARGET},
+    {"SYNC", Format::NONE},
+    {"ILLEGAL", Format::NONE},
+};
+
+const char* const kRegisterNames[InstructionSet::kRegisterCount] = {
+    "R0", "R1", "R2", "R3", "R4", "R5", "R6", "R7",
+    "R8", "R9", "R10", "R11", "R12", "R13", "R14", "R15"};
+
+std::string_view trim(std::string_view text) {
+    size_t begin = 0;
+    while (begin < text.size() && std::isspace(static_cast<unsigned char>(text[begin]))) {
+        ++begin;
+    }
+    size_t end = text.size();
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+        --end;
+    }
+    return text.substr(begin, end - begin);
+}
+
+std::string_view stripComment(std::string_view line) {
+    size_t comment = line.find_first_of(";#");
+    return trim(comment == std::string_view::npos ? line : line.substr(0, comment));
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(a[i])) != std::toupper(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isIdentifier(std::string_view text) {
+    if (text.empty() || std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    for (char c : text) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '.') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Splits "loop: ADD R1, R2, R3" into its label (possibly empty) and the instruction text
+std::string_view splitLabel(std::string_view line, std::string_view& label) {
+    size_t colon = line.find(':');
+    if (colon != std::string_view::npos && isIdentifier(trim(line.substr(0, colon)))) {
+        label = trim(line.substr(0, colon));
+        return trim(line.substr(colon + 1));
+    }
+    label = std::string_view();
+    return line;
+}
+
+[[noreturn]] void fail(const std::string& message, std::string_view text) {
+    throw ProcessorSimulatorException(message + ": " + std::string(text));
+}
+
+int parseRegister(std::string_view operand) {
+    int index = InstructionSet::registerIndex(trim(operand));
+    if (index < 0) {
+        fail("Invalid register", operand);
+    }
+    return index;
+}
+
+// Decimal, 0x hex or 0b binary, optionally negative; must fit in 32 signed bits
+bool parseNumber(std::string_view text, int32_t& value) {
+    text = trim(text);
+    bool negative = !text.empty() && text[0] == '-';
+    if (negative || (!text.empty() && text[0] == '+')) {
+        text.remove_prefix(1);
+    }
+
+    unsigned base = 10;
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        base = 16;
+        text.remove_prefix(2);
+    } else if (text.size() > 2 && text[0] == '0' && (text[1] == 'b' || text[1] == 'B')) {
+        base = 2;
+        text.remove_prefix(2);
+    }
+    if (text.empty()) {
+        return false;
+    }
+
+    uint64_t magnitude = 0;
+    for (char c : text) {
+        unsigned digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<unsigned>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<unsigned>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<unsigned>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        if (digit >= base) {
+            return false;
+        }
+        magnitude = magnitude * base + digit;
+        if (magnitude > (uint64_t{1} << 31)) {
+            return false;
+        }
+    }
+
+    if (negative) {
+        value = static_cast<int32_t>(-static_cast<int64_t>(magnitude));
+        return true;
+    }
+    if (magnitude > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+        return false;
+    }
+    value = static_cast<int32_t>(magnitude);
+    return true;
+}
+
+int32_t parseImmediate(std::string_view operand) {
+    int32_t value = 0;
+    if (!parseNumber(operand, value)) {
+        fail("Invalid immediate", operand);
+    }
+    return value;
+}
+
+int32_t parseTarget(std::string_view operand, const InstructionSet::Labels* labels) {
+    operand = trim(operand);
+    int32_t value = 0;
+    if (parseNumber(operand, value)) {
+        return value;
+    }
+    if (labels != nullptr) {
+        auto it = labels->find(std::string(operand));
+        if (it != labels->end()) {
+            if (it->second > static_cast<uint64_t>(std::numeric_limits<int32_t>::max())) {
+                fail("Label address out of range", operand);
+            }
+            return static_cast<int32_t>(it->second);
+        }
+    }
+    fail("Unknown label", operand);
+}
+
+// "imm(Rn)" or "(Rn)"
+void parseMemoryOperand(std::string_view operand, Instruction& instruction) {
+    operand = trim(operand);
+    size_t open = operand.find('(');
+    if (open == std::string_view::npos || operand.back() != ')') {
+        fail("Invalid memory operand", operand);
+    }
+    std::string_view offset = trim(operand.substr(0, open));
+    instruction.imm = offset.empty() ? 0 : parseImmediate(offset);
+    instruction.rs1 = static_cast<uint8_t>(parseRegister(operand.substr(open + 1, operand.size() - open - 2)));
+}
+
+} // namespace
+
+uint64_t Instruction::encode() const {
+    return static_cast<uint64_t>(op) |
+           static_cast<uint64_t>(rd) << 8 |
+           static_cast<uint64_t>(rs1) << 16 |
+           static_cast<uint64_t>(rs2) << 24 |
+           static_cast<uint64_t>(static_cast<uint32_t>(imm)) << 32;
+}
+
+Instruction Instruction::decode(uint64_t word) {
+    Instruction instruction;
+    auto op = static_cast<uint8_t>(word);
+    instruction.rd = static_cast<uint8_t>(word >> 8);
+    instruction.rs1 = static_cast<uint8_t>(word >> 16);
+    instruction.rs2 = static_cast<uint8_t>(word >> 24);
+    instruction.imm = static_cast<int32_t>(static_cast<uint32_t>(word >> 32));
+
+    bool validRegisters = instruction.rd < InstructionSet::kRegisterCount &&
+                          instruction.rs1 < InstructionSet::kRegisterCount &&
+                          instruction.rs2 < InstructionSet::kRegisterCount;
+    instruction.op = op < static_cast<uint8_t>(Opcode::ILLEGAL) && validRegisters
+        ? static_cast<Opcode>(op) : Opcode::ILLEGAL;
+    return instruction;
+}
+
+Instruction InstructionSet::assemble(std::string_view text, const Labels* labels) {
+    std::string_view line = stripComment(text);
+    size_t split = 0;
+    while (split < line.size() && !std::isspace(static_cast<unsigned char>(line[split]))) {
+        ++split;
+    }
+    std::string_view name = line.substr(0, split);
+    std::string_view rest = trim(line.substr(split));
+
+    size_t opcode = 0;
+    while (opcode < static_cast<size_t>(Opcode::ILLEGAL) && !equalsIgnoreCase(name, kOpcodes[opcode].name)) {
+        ++opcode;
+    }
+    if (opcode == static_cast<size_t>(Opcode::ILLEGAL)) {
+        fail("Unknown instruction", text);
+    }
+
+    // Split the operands on commas; memory operands never contain one
+    std::string_view operands[3];
+    size_t operandCount = 0;
+    while (!rest.empty()) {
+        if (operandCount == 3) {
+            fail("Too many operands", text);
+        }
+        size_t comma = rest.find(',');
+        operands[operandCount++] = trim(rest.substr(0, comma));
+        rest = comma == std::string_view::npos ? std::string_view() : trim(rest.substr(comma + 1));
+    }
+
+    static const size_t kOperandCounts[] = {0, 2, 2, 3, 3, 2, 2, 2, 2, 1};
+    Format format = kOpcodes[opcode].format;
+    if (operandCount != kOperandCounts[static_cast<size_t>(format)]) {
+        fail("Wrong number of operands", text);
+    }
+
+    Instruction instruction;
+    instruction.op = static_cast<Opcode>(opcode);
+    switch (format) {
+        case Format::NONE:
+            break;
+        case Format::REG_IMM:
+            instruction.rd = static_cast<uint8_t>(parseRegister(operands[0]));
+            instruction.imm = parseImmediate(operands[1]);
+            break;
+        case Format::REG_REG:
+            instruction.rd = static_cast<uint8_t>(parseRegister(operands[0]));
+            instruction.rs1 = static_cast<uint8_t>(parseRegister(operands[1]));
+            break;
+        case Format::REG_REG_REG:
+            instruction.rd = static_cast<uint8_t>(parseRegister(operands[0]));
+            instruction.rs1 = static_cast<uint8_t>(parseRegister(operands[1]));
+            instruction.rs2 = static_cast<uint8_t>(parseRegister(operands[2]));
+            break;
+        case Format::REG_REG_IMM:
+            instruction.rd = static_cast<uint8_t>(parseRegister(operands[0]));
+            instruction.rs1 = static_cast<uint8_t>(parseRegister(operands[1]));
+            instruction.imm = parseImmediate(operands[2]);
+            break;
+        case Format::LOAD:
+            instruction.rd = static_cast<uint8_t>(parseRegister(operands[0]));
+            parseMemoryOperand(operands[1], instruction);
+            break;
+        case Format::STORE:
+            instruction.rs2 = static_cast<uint8_t>(parseRegister(operands[0]));
+            parseMemoryOperand(operands[1], instruction);
+            break;
+        case Format::COMPARE:
+            instruction.rs1 = static_cast<uint8_t>(parseRegister(operands[0]));
+            instruction.rs2 = static_cast<uint8_t>(parseRegister(operands[1]));
+            break;
+        case Format::COMPARE_IMM:
+            instruction.rs1 = static_cast<uint8_t>(parseRegister(operands[0]));
+            instruction.imm = parseImmediate(operands[1]);
+            break;
+        case Format::TARGET:
+            instruction.imm = parseTarget(operands[0], labels);
+            break;
+    }
+    return instruction;
+}
+
+Program InstructionSet::assembleProgram(std::string_view source, uint64_t base) {
+    if (base % kInstructionBytes != 0) {
+        throw ProcessorSimulatorException("Program base address must be 8-byte aligned");
+    }
+
+    // First pass: label addresses
+    Labels labels;
+    std::vector<std::string_view> lines;
+    uint64_t address = base;
+    size_t begin = 0;
+    while (begin <= source.size()) {
+        size_t end = source.find('\n', begin);
+        if (end == std::string_view::npos) {
+            end = source.size();
+        }
+        std::string_view label;
+        std::string_view text = splitLabel(stripComment(source.substr(begin, end - begin)), label);
+        if (!label.empty() && !labels.emplace(std::string(label), address).second) {
+            fail("Duplicate label", label);
+        }
+        lines.push_back(text);
+        if (!text.empty()) {
+            address += kInstructionBytes;
+        }
+        begin = end + 1;
+    }
+
+    // Second pass: instructions
+    Program program;
+    program.base = base;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (lines[i].empty()) {
+            continue;
+        }
+        try {
+            program.code.push_back(assemble(lines[i], &labels));
+        } catch (const ProcessorSimulatorException& e) {
+            throw ProcessorSimulatorException("Line " + std::to_string(i + 1) + ": " + e.what());
+        }
+    }
+    return program;
+}
+
+std::string InstructionSet::disassemble(const Instruction& instruction) {
+    std::string text = mnemonic(instruction.op);
+    auto reg = [](uint8_t index) { return std::string(registerName(index)); };
+    auto imm = std::to_string(instruction.imm);
+
+    size_t op = static_cast<size_t>(instruction.op);
+    switch (op < kOpcodeCount ? kOpcodes[op].format : Format::NONE) {
+        case Format::NONE:
+            break;
+        case Format::REG_IMM:
+            text += " " + reg(instruction.rd) + ", " + imm;
+            break;
+        case Format::REG_REG:
+            text += " " + reg(instruction.rd) + ", " + reg(instruction.rs1);
+            break;
+        case Format::REG_REG_REG:
+            text += " " + reg(instruction.rd) + ", " + reg(instruction.rs1) + ", " + reg(instruction.rs2);
+            break;
+        case Format::REG_REG_IMM:
+            text += " " + reg(instruction.rd) + ", " + reg(instruction.rs1) + ", " + imm;
+            break;
+        case Format::LOAD:
+            text += " " + reg(instruction.rd) + ", " + imm + "(" + reg(instruction.rs1) + ")";
+            break;
+        case Format::STORE:
+            text += " " + reg(instruction.rs2) + ", " + imm + "(" + reg(instruction.rs1) + ")";
+            break;
+        case Format::COMPARE:
+            text += " " + reg(instruction.rs1) + ", " + reg(instruction.rs2);
+            break;
+        case Format::COMPARE_IMM:
+            text += " " + reg(instruction.rs1) + ", " + imm;
+            break;
+        case Format::TARGET:
+            text += " " + imm;
+            break;
+    }
+    return text;
+}
+
+const char* InstructionSet::mnemonic(Opcode op) {
+    size_t index = static_cast<size_t>(op);
+    return index < kOpcodeCount ? kOpcodes[index].name : "ILLEGAL";
+}
+
+const char* InstructionSet::registerName(size_t index) {
+    return index < kRegisterCount ? kRegisterNames[index] : "R?";
+}
+
+int InstructionSet::registerIndex(std::string_view name) {
+    if (name.size() < 2 || name.size() > 3 || (name[0] != 'R' && name[0] != 'r')) {
+        return -1;
+    }
+    int index = 0;
+    for (size_t i = 1; i < name.size(); ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(name[i]))) {
+            return -1;
+        }
+        index = index * 10 + (name[i] - '0');
+    }
+    // Reject "R01" so every register has exactly one spelling
+    if (name.size() == 3 && name[1] == '0') {
+        return -1;
+    }
+    return index < static_cast<int>(kRegisterCount) ? index : -1;
+}
@@ -0,0 +1,120 @@
+#ifndef INSTRUCTION_SET_HPP
+#define INSTRUCTION_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// The simulated machine: a small load/store RISC processor with sixteen
+// 64-bit registers (R0-R15), a program counter, Z/N/C condition flags set by
+// CMP/CMPI and a byte-addressed 64-bit memory.
+//
+// Every instruction is one 64-bit word:
+//   bits  0-7   opcode
+//   bits  8-15  rd
+//   bits 16-23  rs1
+//   bits 24-31  rs2
+//   bits 32-63  imm (two's complement)
+//
+// Assembly syntax is one instruction per line. ';' or '#' start a comment,
+// "name:" defines a label, immediates are decimal, 0x hex or 0b binary.
+//
+//   NOP                       no operation
+//   HALT                      stop run()
+//   LI    rd, imm             rd = imm (sign-extended)
+//   MOV   rd, rs1             rd = rs1
+//   ADD   rd, rs1, rs2        also SUB, AND, OR, XOR, SHL, SHR (logical), MUL
+//   ADDI  rd, rs1, imm        rd = rs1 + imm
+//   LOAD  rd, imm(rs1)        rd = mem64[rs1 + imm]
+//   STORE rs2, imm(rs1)       mem64[rs1 + imm] = rs2
+//   CMP   rs1, rs2            set flags from rs1 - rs2
+//   CMPI  rs1, imm            set flags from rs1 - imm
+//   JMP   target              target is a label or an absolute byte address
+//   BEQ, BNE target           branch if equal / not equal
+//   BLT, BGE target           signed less than / greater or equal
+//   BLTU, BGEU target         unsigned less than / greater or equal
+//   SYNC                      synchronization point: ends the core's time
+//                             quantum on a multi-core simulator, no-op otherwise
+//
+// Memory accesses are 8 bytes wide and must be 8-byte aligned.
+enum class Opcode : uint8_t {
+    NOP,
+    HALT,
+    LI,
+    MOV,
+    ADD,
+    SUB,
+    AND,
+    OR,
+    XOR,
+    SHL,
+    SHR,
+    MUL,
+    ADDI,
+    LOAD,
+    STORE,
+    CMP,
+    CMPI,
+    JMP,
+    BEQ,
+    BNE,
+    BLT,
+    BGE,
+    BLTU,
+    BGEU,
+    SYNC,
+    ILLEGAL
+};
+
+// Decoded form of one instruction word
+struct Instruction {
+    Opcode op = Opcode::NOP;
+    uint8_t rd = 0;
+    uint8_t rs1 = 0;
+    uint8_t rs2 = 0;
+    int32_t imm = 0;
+
+    uint64_t encode() const;
+
+    // Unknown opcodes and out-of-range registers decode to ILLEGAL
+    static Instruction decode(uint64_t word);
+};
+
+// Assembled code placed at a fixed byte address
+struct Program {
+    uint64_t base = 0;
+    std::vector<Instruction> code;
+
+    uint64_t endAddress() const { return base + code.size() * sizeof(uint64_t); }
+    bool contains(uint64_t address) const { return address >= base && address < endAddress(); }
+};
+
+class InstructionSet {
+public:
+    static constexpr size_t kRegisterCount = 16;
+    static constexpr size_t kOpcodeCount = static_cast<size_t>(Opcode::ILLEGAL) + 1;
+    static constexpr uint64_t kInstructionBytes = sizeof(uint64_t);
+
+    using Labels = std::unordered_map<std::string, uint64_t>;
+
+    // Assembles one instruction; branch targets may only name labels when `labels` is given
+    static Instruction assemble(std::string_view text, const Labels* labels = nullptr);
+
+    // Assembles a whole source file, resolving labels relative to `base`
+    static Program assembleProgram(std::string_view source, uint64_t base = 0);
+
+    static std::string disassemble(const Instruction& instruction);
+
+    static const char* mnemonic(Opcode op);
+
+    // "R0".."R15"
+    static const char* registerName(size_t index);
+
+    // Register index for "R0".."R15" (case-insensitive), or -1
+    static int registerIndex(std::string_view name);
+};
+
+#endif // INSTRUCTION_SET_HPP
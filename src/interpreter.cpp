@@ -0,0 +1,550 @@
+#include "interpreter.hpp"
+#include "execution_trace.hpp"
+
+#include <array>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using State = Interpreter::State;
+
+struct Context {
+    State& state;
+    SimulatedMemory& memory;
+    Program* program;
+    bool codeModified = false;  // A STORE changed the program
+};
+
+using Handler = void (*)(Context&, const Instruction&);
+
+constexpr uint64_t kStep = InstructionSet::kInstructionBytes;
+
+uint64_t reg(Context& c, uint8_t index) {
+    return c.state.readRegister(index);
+}
+
+uint64_t immediate(const Instruction& i) {
+    return static_cast<uint64_t>(static_cast<int64_t>(i.imm));
+}
+
+void next(Context& c) {
+    c.state.setPc(c.state.getPc() + kStep);
+}
+
+void setRegister(Context& c, uint8_t index, uint64_t value) {
+    c.state.writeRegister(index, value);
+    next(c);
+}
+
+uint8_t compareFlags(uint64_t a, uint64_t b) {
+    uint8_t flags = 0;
+    if (a == b) {
+        flags |= State::kFlagZero;
+    }
+    if (static_cast<int64_t>(a) < static_cast<int64_t>(b)) {
+        flags |= State::kFlagNegative;
+    }
+    if (a < b) {
+        flags |= State::kFlagCarry;
+    }
+    return flags;
+}
+
+void compare(Context& c, uint64_t a, uint64_t b) {
+    c.state.setFlags(compareFlags(a, b));
+    next(c);
+}
+
+void branchIf(Context& c, const Instruction& i, bool taken) {
+    c.state.setPc(taken ? immediate(i) : c.state.getPc() + kStep);
+}
+
+bool flag(Context& c, uint8_t mask) {
+    return (c.state.getFlags() & mask) != 0;
+}
+
+[[noreturn]] void throwIllegal(uint64_t pc) {
+    std::ostringstream message;
+    message << "Illegal instruction at 0x" << std::hex << pc;
+    throw ProcessorSimulatorException(message.str());
+}
+
+[[noreturn]] void illegal(Context& c, const Instruction&) {
+    throwIllegal(c.state.getPc());
+}
+
+// Indexed by opcode
+const Handler kHandlers[InstructionSet::kOpcodeCount] = {
+    /* NOP */   [](Context& c, const Instruction&) { next(c); },
+    /* HALT */  [](Context& c, const Instruction&) { c.state.setHalted(true); },
+    /* LI */    [](Context& c, const Instruction& i) { setRegister(c, i.rd, immediate(i)); },
+    /* MOV */   [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1)); },
+    /* ADD */   [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) + reg(c, i.rs2)); },
+    /* SUB */   [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) - reg(c, i.rs2)); },
+    /* AND */   [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) & reg(c, i.rs2)); },
+    /* OR */    [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) | reg(c, i.rs2)); },
+    /* XOR */   [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) ^ reg(c, i.rs2)); },
+    /* SHL */   [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) << (reg(c, i.rs2) & 63)); },
+    /* SHR */   [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) >> (reg(c, i.rs2) & 63)); },
+    /* MUL */   [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) * reg(c, i.rs2)); },
+    /* ADDI */  [](Context& c, const Instruction& i) { setRegister(c, i.rd, reg(c, i.rs1) + immediate(i)); },
+    /* LOAD */  [](Context& c, const Instruction& i) {
+        setRegister(c, i.rd, c.memory.load64(reg(c, i.rs1) + immediate(i)));
+    },
+    /* STORE */ [](Context& c, const Instruction& i) {
+        uint64_t address = reg(c, i.rs1) + immediate(i);
+        uint64_t value = reg(c, i.rs2);
+        c.memory.store64(address, value);
+        // Self-modifying code: keep the decoded program in step with memory
+        if (c.program != nullptr && c.program->contains(address)) {
+            c.program->code[(address - c.program->base) / kStep] = Instruction::decode(value);
+            c.codeModified = true;
+        }
+        next(c);
+    },
+    /* CMP */   [](Context& c, const Instruction& i) { compare(c, reg(c, i.rs1), reg(c, i.rs2)); },
+    /* CMPI */  [](Context& c, const Instruction& i) { compare(c, reg(c, i.rs1), immediate(i)); },
+    /* JMP */   [](Context& c, const Instruction& i) { branchIf(c, i, true); },
+    /* BEQ */   [](Context& c, const Instruction& i) { branchIf(c, i, flag(c, State::kFlagZero)); },
+    /* BNE */   [](Context& c, const Instruction& i) { branchIf(c, i, !flag(c, State::kFlagZero)); },
+    /* BLT */   [](Context& c, const Instruction& i) { branchIf(c, i, flag(c, State::kFlagNegative)); },
+    /* BGE */   [](Context& c, const Instruction& i) { branchIf(c, i, !flag(c, State::kFlagNegative)); },
+    /* BLTU */  [](Context& c, const Instruction& i) { branchIf(c, i, flag(c, State::kFlagCarry)); },
+    /* BGEU */  [](Context& c, const Instruction& i) { branchIf(c, i, !flag(c, State::kFlagCarry)); },
+    /* SYNC */  [](Context& c, const Instruction&) { next(c); },
+    /* ILLEGAL */ illegal,
+};
+
+// Index of the instruction at `pc`; throws if there is none
+size_t instructionIndex(const Program& program, uint64_t pc) {
+    uint64_t offset = pc - program.base;
+    uint64_t index = offset / kStep;
+    if (offset % kStep != 0 || index >= program.code.size()) {
+        std::ostringstream message;
+        message << "PC outside the loaded program: 0x" << std::hex << pc;
+        throw ProcessorSimulatorException(message.str());
+    }
+    return static_cast<size_t>(index);
+}
+
+// The dispatch loop; `execute(context, instruction, pc)` carries out each
+// step. Stores into the program clear `blocks`.
+template <typename Execute>
+uint64_t runLoop(State& state, SimulatedMemory& memory, Program& program, uint64_t maxSteps,
+                 BlockCache* blocks, Execute execute) {
+    Context context{state, memory, &program};
+    uint64_t steps = 0;
+
+    while (steps < maxSteps && !state.isHalted()) {
+        uint64_t pc = state.getPc();
+        size_t index = instructionIndex(program, pc);
+        // A copy: a STORE may overwrite the decoded instruction it came from
+        const Instruction instruction = program.code[index];
+        execute(context, instruction, pc);
+        ++steps;
+        if (context.codeModified) {
+            context.codeModified = false;
+            if (blocks != nullptr) {
+                blocks->clear();
+            }
+        }
+        if (instruction.op == Opcode::SYNC) {
+            break;
+        }
+    }
+    return steps;
+}
+
+void dispatch(Context& c, const Instruction& instruction, uint64_t) {
+    kHandlers[static_cast<size_t>(instruction.op)](c, instruction);
+}
+
+// A step and its trace record in one call; the opcode is a template
+// argument so both the handler and the encoding are specialised
+using TracedHandler = void (*)(Context&, TraceWriter&, const Instruction&, uint64_t);
+
+template <size_t Op>
+void tracedStep(Context& c, TraceWriter& trace, const Instruction& instruction, uint64_t pc) {
+    kHandlers[Op](c, instruction);
+    trace.recordStep<static_cast<Opcode>(Op)>(c.state, instruction, pc);
+}
+
+template <size_t... Ops>
+constexpr std::array<TracedHandler, sizeof...(Ops)> tracedHandlers(std::index_sequence<Ops...>) {
+    return {tracedStep<Ops>...};
+}
+
+constexpr std::array<TracedHandler, InstructionSet::kOpcodeCount> kTracedHandlers =
+    tracedHandlers(std::make_index_sequence<InstructionSet::kOpcodeCount>());
+
+// Second tier: translated blocks.
+//
+// A block is an array of BlockOps ending in one that leaves the block. Each
+// handler returns the next op, or nullptr once it has set the PC and the
+// number of instructions executed. The PC is not kept up to date inside a
+// block; an op that can fault has it restored from BlockOp::pc.
+
+struct BlockContext {
+    State& state;
+    SimulatedMemory& memory;
+    Program& program;
+    uint64_t executed = 0;      // Set by the op that leaves the block
+    bool codeModified = false;  // A STORE changed the program
+    bool synced = false;        // The block ended with SYNC
+};
+
+struct BlockOp;
+using BlockHandler = const BlockOp* (*)(BlockContext&, const BlockOp*);
+
+struct BlockOp {
+    BlockHandler handler = nullptr;
+    uint64_t imm = 0;       // Sign-extended immediate
+    uint64_t target = 0;    // Branch target, or where a fall-through exit continues
+    uint64_t pc = 0;        // Address of the (first) instruction
+    uint32_t executed = 0;  // Instructions of the block up to and including this op
+    uint8_t rd = 0;
+    uint8_t rs1 = 0;
+    uint8_t rs2 = 0;
+};
+
+uint64_t blockReg(BlockContext& c, uint8_t index) {
+    return c.state.readRegister(index);
+}
+
+const BlockOp* leave(BlockContext& c, const BlockOp* op, uint64_t pc) {
+    c.state.setPc(pc);
+    c.executed = op->executed;
+    return nullptr;
+}
+
+using AluFunction = uint64_t (*)(uint64_t, uint64_t);
+
+template <AluFunction F>
+const BlockOp* blockAlu(BlockContext& c, const BlockOp* op) {
+    c.state.writeRegister(op->rd, F(blockReg(c, op->rs1), blockReg(c, op->rs2)));
+    return op + 1;
+}
+
+uint64_t aluAdd(uint64_t a, uint64_t b) { return a + b; }
+uint64_t aluSub(uint64_t a, uint64_t b) { return a - b; }
+uint64_t aluAnd(uint64_t a, uint64_t b) { return a & b; }
+uint64_t aluOr(uint64_t a, uint64_t b) { return a | b; }
+uint64_t aluXor(uint64_t a, uint64_t b) { return a ^ b; }
+uint64_t aluShl(uint64_t a, uint64_t b) { return a << (b & 63); }
+uint64_t aluShr(uint64_t a, uint64_t b) { return a >> (b & 63); }
+uint64_t aluMul(uint64_t a, uint64_t b) { return a * b; }
+
+template <Opcode Branch>
+bool branchTaken(uint8_t flags) {
+    switch (Branch) {
+        case Opcode::BEQ: return (flags & State::kFlagZero) != 0;
+        case Opcode::BNE: return (flags & State::kFlagZero) == 0;
+        case Opcode::BLT: return (flags & State::kFlagNegative) != 0;
+        case Opcode::BGE: return (flags & State::kFlagNegative) == 0;
+        case Opcode::BLTU: return (flags & State::kFlagCarry) != 0;
+        case Opcode::BGEU: return (flags & State::kFlagCarry) == 0;
+        default: return true;
+    }
+}
+
+template <Opcode Branch>
+const BlockOp* blockBranch(BlockContext& c, const BlockOp* op) {
+    return leave(c, op, branchTaken<Branch>(c.state.getFlags()) ? op->target : op->pc + kStep);
+}
+
+// Superinstruction: CMP or CMPI followed by a conditional branch
+template <Opcode Branch, bool Immediate>
+const BlockOp* blockCompareBranch(BlockContext& c, const BlockOp* op) {
+    uint8_t flags = compareFlags(blockReg(c, op->rs1), Immediate ? op->imm : blockReg(c, op->rs2));
+    c.state.setFlags(flags);
+    return leave(c, op, branchTaken<Branch>(flags) ? op->target : op->pc + 2 * kStep);
+}
+
+const BlockOp* blockStore(BlockContext& c, const BlockOp* op) {
+    uint64_t address = blockReg(c, op->rs1) + op->imm;
+    uint64_t value = blockReg(c, op->rs2);
+    c.memory.store64(address, value);
+    if (c.program.contains(address)) {
+        // The rest of this block may be stale
+        c.program.code[(address - c.program.base) / kStep] = Instruction::decode(value);
+        c.codeModified = true;
+        return leave(c, op, op->pc + kStep);
+    }
+    return op + 1;
+}
+
+// Indexed by opcode; NOP is dropped during translation
+const BlockHandler kBlockHandlers[InstructionSet::kOpcodeCount] = {
+    /* NOP */   nullptr,
+    /* HALT */  [](BlockContext& c, const BlockOp* op) {
+        c.state.setHalted(true);
+        return leave(c, op, op->pc);
+    },
+    /* LI */    [](BlockContext& c, const BlockOp* op) {
+        c.state.writeRegister(op->rd, op->imm);
+        return op + 1;
+    },
+    /* MOV */   [](BlockContext& c, const BlockOp* op) {
+        c.state.writeRegister(op->rd, blockReg(c, op->rs1));
+        return op + 1;
+    },
+    /* ADD */   blockAlu<aluAdd>,
+    /* SUB */   blockAlu<aluSub>,
+    /* AND */   blockAlu<aluAnd>,
+    /* OR */    blockAlu<aluOr>,
+    /* XOR */   blockAlu<aluXor>,
+    /* SHL */   blockAlu<aluShl>,
+    /* SHR */   blockAlu<aluShr>,
+    /* MUL */   blockAlu<aluMul>,
+    /* ADDI */  [](BlockContext& c, const BlockOp* op) {
+        c.state.writeRegister(op->rd, blockReg(c, op->rs1) + op->imm);
+        return op + 1;
+    },
+    /* LOAD */  [](BlockContext& c, const BlockOp* op) {
+        c.state.writeRegister(op->rd, c.memory.load64(blockReg(c, op->rs1) + op->imm));
+        return op + 1;
+    },
+    /* STORE */ blockStore,
+    /* CMP */   [](BlockContext& c, const BlockOp* op) {
+        c.state.setFlags(compareFlags(blockReg(c, op->rs1), blockReg(c, op->rs2)));
+        return op + 1;
+    },
+    /* CMPI */  [](BlockContext& c, const BlockOp* op) {
+        c.state.setFlags(compareFlags(blockReg(c, op->rs1), op->imm));
+        return op + 1;
+    },
+    /* JMP */   [](BlockContext& c, const BlockOp* op) { return leave(c, op, op->target); },
+    /* BEQ */   blockBranch<Opcode::BEQ>,
+    /* BNE */   blockBranch<Opcode::BNE>,
+    /* BLT */   blockBranch<Opcode::BLT>,
+    /* BGE */   blockBranch<Opcode::BGE>,
+    /* BLTU */  blockBranch<Opcode::BLTU>,
+    /* BGEU */  blockBranch<Opcode::BGEU>,
+    /* SYNC */  [](BlockContext& c, const BlockOp* op) {
+        c.synced = true;
+        return leave(c, op, op->pc + kStep);
+    },
+    /* ILLEGAL */ [](BlockContext&, const BlockOp* op) -> const BlockOp* { throwIllegal(op->pc); },
+};
+
+// Indexed by [CMPI][branch opcode - BEQ]
+const BlockHandler kCompareBranchHandlers[2][6] = {
+    {blockCompareBranch<Opcode::BEQ, false>, blockCompareBranch<Opcode::BNE, false>,
+     blockCompareBranch<Opcode::BLT, false>, blockCompareBranch<Opcode::BGE, false>,
+     blockCompareBranch<Opcode::BLTU, false>, blockCompareBranch<Opcode::BGEU, false>},
+    {blockCompareBranch<Opcode::BEQ, true>, blockCompareBranch<Opcode::BNE, true>,
+     blockCompareBranch<Opcode::BLT, true>, blockCompareBranch<Opcode::BGE, true>,
+     blockCompareBranch<Opcode::BLTU, true>, blockCompareBranch<Opcode::BGEU, true>},
+};
+
+bool isConditionalBranch(Opcode op) {
+    return op >= Opcode::BEQ && op <= Opcode::BGEU;
+}
+
+// Instructions after which a block ends
+bool endsBlock(Opcode op) {
+    return op == Opcode::HALT || op == Opcode::JMP || isConditionalBranch(op) ||
+           op == Opcode::SYNC || op == Opcode::ILLEGAL;
+}
+
+} // namespace
+
+struct TranslatedBlock {
+    std::vector<BlockOp> ops;
+    uint32_t length = 0;  // Instructions, including dropped NOPs
+};
+
+namespace {
+
+std::unique_ptr<TranslatedBlock> translate(const Program& program, size_t start) {
+    auto block = std::make_unique<TranslatedBlock>();
+    const std::vector<Instruction>& code = program.code;
+    size_t index = start;
+    uint32_t count = 0;
+
+    while (index < code.size() && count < BlockCache::kMaxBlockInstructions) {
+        const Instruction& instruction = code[index];
+        BlockOp op;
+        op.pc = program.base + index * kStep;
+        op.rd = instruction.rd;
+        op.rs1 = instruction.rs1;
+        op.rs2 = instruction.rs2;
+        op.imm = immediate(instruction);
+
+        bool compare = instruction.op == Opcode::CMP || instruction.op == Opcode::CMPI;
+        if (compare && index + 1 < code.size() && isConditionalBranch(code[index + 1].op) &&
+            count + 2 <= BlockCache::kMaxBlockInstructions) {
+            Opcode branch = code[index + 1].op;
+            op.handler = kCompareBranchHandlers[instruction.op == Opcode::CMPI]
+                                               [static_cast<size_t>(branch) - static_cast<size_t>(Opcode::BEQ)];
+            op.target = immediate(code[index + 1]);
+            count += 2;
+            op.executed = count;
+            block->ops.push_back(op);
+            block->length = count;
+            return block;
+        }
+
+        ++count;
+        ++index;
+        if (instruction.op == Opcode::NOP) {
+            continue;
+        }
+        op.handler = kBlockHandlers[static_cast<size_t>(instruction.op)];
+        op.target = op.imm;
+        op.executed = count;
+        block->ops.push_back(op);
+        if (endsBlock(instruction.op)) {
+            block->length = count;
+            return block;
+        }
+    }
+
+    // Out of room or out of program: continue at the next instruction
+    BlockOp exit;
+    exit.handler = [](BlockContext& c, const BlockOp* op) { return leave(c, op, op->target); };
+    exit.pc = program.base + index * kStep;
+    exit.target = exit.pc;
+    exit.executed = count;
+    block->ops.push_back(exit);
+    block->length = count;
+    return block;
+}
+
+// Runs `block` from its first op; returns the instructions executed. If an
+// op faults, `c.executed` is left holding the instructions before it.
+uint64_t runBlock(BlockContext& c, const TranslatedBlock& block) {
+    const BlockOp* op = block.ops.data();
+    try {
+        while (op != nullptr) {
+            op = op->handler(c, op);
+        }
+    } catch (...) {
+        c.state.setPc(op->pc);
+        c.executed = op->executed - 1;
+        throw;
+    }
+    uint64_t executed = c.executed;
+    c.executed = 0;
+    return executed;
+}
+
+} // namespace
+
+BlockCache::BlockCache() = default;
+BlockCache::~BlockCache() = default;
+BlockCache::BlockCache(BlockCache&&) noexcept = default;
+BlockCache& BlockCache::operator=(BlockCache&&) noexcept = default;
+
+void BlockCache::clear() {
+    reset(0);
+}
+
+void BlockCache::reset(size_t instructions) {
+    counters.assign(instructions, 0);
+    blocks.clear();
+    blocks.resize(instructions);
+    translated = 0;
+}
+
+void Interpreter::step(State& state, SimulatedMemory& memory, Program* program, const Instruction& instruction,
+                       BlockCache* blocks) {
+    Context context{state, memory, program};
+    kHandlers[static_cast<size_t>(instruction.op)](context, instruction);
+    if (context.codeModified && blocks != nullptr) {
+        blocks->clear();
+    }
+}
+
+uint64_t Interpreter::run(State& state, SimulatedMemory& memory, Program& program, uint64_t maxSteps) {
+    return runLoop(state, memory, program, maxSteps, nullptr, dispatch);
+}
+
+uint64_t Interpreter::run(State& state, SimulatedMemory& memory, Program& program, BlockCache& blocks,
+                          uint64_t maxSteps) {
+    uint64_t executed = 0;
+    run(state, memory, program, blocks, maxSteps, executed);
+    return executed;
+}
+
+void Interpreter::run(State& state, SimulatedMemory& memory, Program& program, BlockCache& blocks,
+                      uint64_t maxSteps, uint64_t& executed) {
+    const size_t size = program.code.size();
+    if (blocks.blocks.size() != size) {
+        blocks.reset(size);
+    }
+    Context context{state, memory, &program};
+    BlockContext blockContext{state, memory, program};
+    uint64_t steps = 0;
+
+    try {
+        while (steps < maxSteps && !state.isHalted()) {
+            size_t index = instructionIndex(program, state.getPc());
+            TranslatedBlock* block = blocks.blocks[index].get();
+            if (block == nullptr && ++blocks.counters[index] >= BlockCache::kHotThreshold) {
+                blocks.blocks[index] = translate(program, index);
+                block = blocks.blocks[index].get();
+                ++blocks.translated;
+            }
+
+            // Near the step budget, finish instruction by instruction
+            if (block != nullptr && block->length <= maxSteps - steps) {
+                steps += runBlock(blockContext, *block);
+                if (blockContext.codeModified) {
+                    blockContext.codeModified = false;
+                    blocks.reset(size);
+                }
+                if (blockContext.synced) {
+                    blockContext.synced = false;
+                    break;
+                }
+                continue;
+            }
+
+            // A copy: a STORE may overwrite the decoded instruction it came from
+            const Instruction instruction = program.code[index];
+            kHandlers[static_cast<size_t>(instruction.op)](context, instruction);
+            ++steps;
+            if (context.codeModified) {
+                context.codeModified = false;
+                blocks.reset(size);
+            }
+            if (instruction.op == Opcode::SYNC) {
+                break;
+            }
+        }
+    } catch (...) {
+        executed = steps + blockContext.executed;
+        throw;
+    }
+    executed = steps;
+}
+
+uint64_t Interpreter::run(State& state, SimulatedMemory& memory, Program& program, uint64_t maxSteps,
+                          TraceWriter& trace, BlockCache* blocks) {
+    trace.begin(state);
+    uint64_t steps = runLoop(state, memory, program, maxSteps, blocks,
+                             [&](Context& c, const Instruction& instruction, uint64_t pc) {
+                                 kTracedHandlers[static_cast<size_t>(instruction.op)](c, trace, instruction, pc);
+                             });
+    trace.end(state);
+    return steps;
+}
+
+uint64_t Interpreter::run(State& state, SimulatedMemory& memory, Program& program, uint64_t maxSteps,
+                          CacheHierarchy& caches, BlockCache* blocks) {
+    // Addresses are taken before the step, which may overwrite the base register
+    uint64_t steps = runLoop(state, memory, program, maxSteps, blocks,
+        [&](Context& c, const Instruction& instruction, uint64_t pc) {
+            if (instruction.op == Opcode::LOAD || instruction.op == Opcode::STORE) {
+                caches.access(state.readRegister(instruction.rs1) + immediate(instruction),
+                              instruction.op == Opcode::STORE);
+            }
+            dispatch(c, instruction, pc);
+        });
+    caches.retire(steps);
+    return steps;
+}
@@ -0,0 +1,60 @@
+#ifndef INTERPRETER_HPP
+#define INTERPRETER_HPP
+
+#include <cstdint>
+#include "block_cache.hpp"
+#include "cache_hierarchy.hpp"
+#include "instruction_set.hpp"
+#include "processor_simulator.hpp"
+#include "simulated_memory.hpp"
+
+// Executes decoded instructions against a processor state and memory.
+//
+// Instructions are dispatched through a table of per-opcode handlers indexed
+// by the opcode, so a step is one indirect call with no parsing or string
+// lookups.
+//
+// The run() overload that takes a BlockCache adds a second tier. It counts
+// how often each PC is interpreted, and once a PC reaches kHotThreshold it
+// translates the straight-line code from there up to the next branch into a
+// block: an array of pre-decoded operations, each a handler that returns the
+// next one. Blocks skip the per-instruction PC update, bounds check and step
+// count, and fuse a CMP or CMPI with the conditional branch after it into
+// one operation. Stores into the program end the current block and drop all
+// translations, so self-modifying code behaves exactly as when interpreted.
+class TraceWriter;
+
+class Interpreter {
+public:
+    using State = ProcessorSimulator::ProcessorState;
+
+    // Executes one instruction as if it were at the current PC. Stores into
+    // `program`'s address range also update its decoded copy and clear `blocks`.
+    static void step(State& state, SimulatedMemory& memory, Program* program, const Instruction& instruction,
+                     BlockCache* blocks = nullptr);
+
+    // Runs `program` from the current PC until HALT, SYNC or `maxSteps`
+    // instructions; returns the number executed (including the SYNC)
+    static uint64_t run(State& state, SimulatedMemory& memory, Program& program, uint64_t maxSteps);
+
+    // As run(), executing hot code as blocks translated into `blocks`
+    static uint64_t run(State& state, SimulatedMemory& memory, Program& program, BlockCache& blocks,
+                        uint64_t maxSteps);
+
+    // As above, counting into `executed`, which stays accurate when a fault
+    // propagates: the instructions before the faulting one are included
+    static void run(State& state, SimulatedMemory& memory, Program& program, BlockCache& blocks,
+                    uint64_t maxSteps, uint64_t& executed);
+
+    // As run(), recording every step into `trace`. Stores into the program
+    // clear `blocks`, so they can be shared with the block tier.
+    static uint64_t run(State& state, SimulatedMemory& memory, Program& program, uint64_t maxSteps,
+                        TraceWriter& trace, BlockCache* blocks = nullptr);
+
+    // As run(), feeding the address of every LOAD and STORE into `caches`;
+    // `blocks` as for the traced run
+    static uint64_t run(State& state, SimulatedMemory& memory, Program& program, uint64_t maxSteps,
+                        CacheHierarchy& caches, BlockCache* blocks = nullptr);
+};
+
+#endif // INTERPRETER_HPP
@@ -0,0 +1,454 @@
+#include "json_request_parser.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// Nesting limit for skipped values, so hostile bodies cannot exhaust the stack
+constexpr int kMaxDepth = 64;
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+unsigned readHex4(const char* p) {
+    unsigned value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value = (value << 4) | static_cast<unsigned>(hexValue(p[i]));
+    }
+    return value;
+}
+
+void appendUtf8(std::string& out, unsigned codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+// Decode an already validated string body; the result is never longer than `raw`
+void appendUnescaped(std::string& out, std::string_view raw) {
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        char escape = raw[++i];
+        switch (escape) {
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                unsigned codePoint = readHex4(&raw[i + 1]);
+                i += 4;
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF && i + 6 < raw.size() &&
+                    raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+                    unsigned low = readHex4(&raw[i + 3]);
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                }
+                if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+                    codePoint = 0xFFFD;  // Unpaired surrogate
+                }
+                appendUtf8(out, codePoint);
+                break;
+            }
+            default:  // '"', '\\' and '/'
+                out += escape;
+                break;
+        }
+    }
+}
+
+// A member name with its escapes decoded into `decoded` if it has any;
+// escaped keys are rare enough to decode on the spot
+std::string_view decodeKey(std::string_view raw, bool escaped, std::string& decoded) {
+    if (!escaped) {
+        return raw;
+    }
+    appendUnescaped(decoded, raw);
+    return decoded;
+}
+
+} // namespace
+
+bool JsonRequestParser::parseRequest(std::string_view body, ConversionRequestFields& request) {
+    input = body;
+    pos = 0;
+    errorMessage = "";
+    itemLimitExceeded = false;
+    pending.clear();
+    request = ConversionRequestFields();
+
+    skipWhitespace();
+    if (!parseRequestObject(request, 0)) {
+        return false;
+    }
+    skipWhitespace();
+    if (!atEnd()) {
+        return fail("Unexpected data after JSON value");
+    }
+    resolvePending(&request);
+    return true;
+}
+
+template <typename Items>
+bool JsonRequestParser::parseItems(std::string_view body, Items& items, size_t maxItems) {
+    input = body;
+    pos = 0;
+    errorMessage = "";
+    itemLimitExceeded = false;
+    pending.clear();
+    items.clear();
+
+    bool sawItems = false;
+    skipWhitespace();
+    if (!expect('{')) {
+        return false;
+    }
+    skipWhitespace();
+    if (!atEnd() && input[pos] == '}') {
+        ++pos;
+    } else {
+        while (true) {
+            skipWhitespace();
+            RawString key;
+            if (!parseString(key)) return false;
+            skipWhitespace();
+            if (!expect(':')) return false;
+            skipWhitespace();
+
+            std::string decodedName;
+            if (decodeKey(key.text, key.escaped, decodedName) == "items") {
+                if (atEnd() || input[pos] != '[') {
+                    return fail("\"items\" must be an array");
+                }
+                ++pos;
+                sawItems = true;
+                items.clear();
+                pending.clear();
+
+                skipWhitespace();
+                if (!atEnd() && input[pos] == ']') {
+                    ++pos;
+                } else {
+                    while (true) {
+                        if (items.size() == maxItems) {
+                            itemLimitExceeded = true;
+                            return fail("Batch exceeds the item limit");
+                        }
+                        skipWhitespace();
+                        items.emplace_back();
+                        if (!parseRequestObject(items.back(), items.size() - 1)) return false;
+                        skipWhitespace();
+                        if (atEnd()) return fail("Unterminated array");
+                        char c = input[pos++];
+                        if (c == ']') break;
+                        if (c != ',') return fail("Expected ',' or ']' in array");
+                    }
+                }
+            } else if (!skipValue(1)) {
+                return false;
+            }
+
+            skipWhitespace();
+            if (atEnd()) return fail("Unterminated object");
+            char c = input[pos++];
+            if (c == '}') break;
+            if (c != ',') return fail("Expected ',' or '}' in object");
+        }
+    }
+
+    skipWhitespace();
+    if (!atEnd()) {
+        return fail("Unexpected data after JSON value");
+    }
+    if (!sawItems) {
+        return fail("Missing \"items\" array");
+    }
+    resolvePending(items.data());
+    return true;
+}
+
+bool JsonRequestParser::parseBatch(std::string_view body, std::vector<ConversionRequestFields>& items,
+                                   size_t maxItems) {
+    return parseItems(body, items, maxItems);
+}
+
+bool JsonRequestParser::parseBatch(std::string_view body, std::pmr::vector<ConversionRequestFields>& items,
+                                   size_t maxItems) {
+    return parseItems(body, items, maxItems);
+}
+
+bool JsonRequestParser::parseRequestObject(ConversionRequestFields& request, size_t item) {
+    if (!expect('{')) {
+        return false;
+    }
+    skipWhitespace();
+    if (!atEnd() && input[pos] == '}') {
+        ++pos;
+        return true;
+    }
+
+    while (true) {
+        skipWhitespace();
+        RawString key;
+        if (!parseString(key)) return false;
+        skipWhitespace();
+        if (!expect(':')) return false;
+        skipWhitespace();
+
+        std::string decodedName;
+        std::string_view name = decodeKey(key.text, key.escaped, decodedName);
+
+        bool isBinary = name == "binary";
+        bool isMode = name == "mode";
+        if (isBinary || isMode) {
+            if (atEnd() || input[pos] != '"') {
+                return fail(isBinary ? "\"binary\" must be a string" : "\"mode\" must be a string");
+            }
+            RawString value;
+            if (!parseString(value)) return false;
+
+            // A repeated key overrides any earlier escaped value
+            pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                         [&](const PendingString& p) {
+                                             return p.item == item && p.isMode == isMode;
+                                         }),
+                          pending.end());
+            if (value.escaped) {
+                pending.push_back({item, isMode, value.text});
+            } else if (isMode) {
+                request.mode = value.text;
+            } else {
+                request.binary = value.text;
+            }
+        } else if (!skipValue(1)) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (atEnd()) return fail("Unterminated object");
+        char c = input[pos++];
+        if (c == '}') return true;
+        if (c != ',') return fail("Expected ',' or '}' in object");
+    }
+}
+
+bool JsonRequestParser::parseString(RawString& value) {
+    if (!expect('"')) {
+        return false;
+    }
+    size_t start = pos;
+    value.escaped = false;
+    while (pos < input.size()) {
+        char c = input[pos];
+        if (c == '"') {
+            value.text = input.substr(start, pos - start);
+            ++pos;
+            return true;
+        }
+        if (static_cast<unsigned char>(c) < 0x20) {
+            return fail("Control character in string");
+        }
+        if (c == '\\') {
+            value.escaped = true;
+            if (++pos >= input.size()) break;
+            char escape = input[pos];
+            if (escape == 'u') {
+                if (pos + 4 >= input.size()) break;
+                for (size_t i = 1; i <= 4; ++i) {
+                    if (hexValue(input[pos + i]) < 0) {
+                        return fail("Invalid \\u escape");
+                    }
+                }
+                pos += 4;
+            } else if (escape != '"' && escape != '\\' && escape != '/' && escape != 'b' &&
+                       escape != 'f' && escape != 'n' && escape != 'r' && escape != 't') {
+                return fail("Invalid escape sequence");
+            }
+        }
+        ++pos;
+    }
+    return fail("Unterminated string");
+}
+
+bool JsonRequestParser::skipValue(int depth) {
+    if (depth > kMaxDepth) {
+        return fail("JSON nested too deeply");
+    }
+    if (atEnd()) {
+        return fail("Unexpected end of input");
+    }
+
+    char c = input[pos];
+    if (c == '{' || c == '[') {
+        char close = c == '{' ? '}' : ']';
+        ++pos;
+        skipWhitespace();
+        if (!atEnd() && input[pos] == close) {
+            ++pos;
+            return true;
+        }
+        while (true) {
+            skipWhitespace();
+            if (c == '{') {
+                RawString key;
+                if (!parseString(key)) return false;
+                skipWhitespace();
+                if (!expect(':')) return false;
+                skipWhitespace();
+            }
+            if (!skipValue(depth + 1)) return false;
+            skipWhitespace();
+            if (atEnd()) return fail("Unterminated container");
+            char next = input[pos++];
+            if (next == close) return true;
+            if (next != ',') return fail("Expected ',' in container");
+        }
+    }
+
+    RawString ignored;
+    switch (c) {
+        case '"': return parseString(ignored);
+        case 't': return skipLiteral("true");
+        case 'f': return skipLiteral("false");
+        case 'n': return skipLiteral("null");
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                return skipNumber();
+            }
+            return fail("Unexpected character");
+    }
+}
+
+bool JsonRequestParser::skipNumber() {
+    auto isDigit = [this]() { return !atEnd() && input[pos] >= '0' && input[pos] <= '9'; };
+    auto skipDigits = [&]() {
+        if (!isDigit()) return false;
+        while (isDigit()) ++pos;
+        return true;
+    };
+
+    if (input[pos] == '-') ++pos;
+    if (!atEnd() && input[pos] == '0') {
+        ++pos;
+    } else if (!skipDigits()) {
+        return fail("Invalid number");
+    }
+    if (!atEnd() && input[pos] == '.') {
+        ++pos;
+        if (!skipDigits()) return fail("Invalid number");
+    }
+    if (!atEnd() && (input[pos] == 'e' || input[pos] == 'E')) {
+        ++pos;
+        if (!atEnd() && (input[pos] == '+' || input[pos] == '-')) ++pos;
+        if (!skipDigits()) return fail("Invalid number");
+    }
+    return true;
+}
+
+bool JsonRequestParser::skipLiteral(std::string_view literal) {
+    if (input.substr(pos, literal.size()) != literal) {
+        return fail("Invalid literal");
+    }
+    pos += literal.size();
+    return true;
+}
+
+bool JsonRequestParser::expect(char c) {
+    if (atEnd() || input[pos] != c) {
+        switch (c) {
+            case '{': return fail("Expected '{'");
+            case ':': return fail("Expected ':'");
+            default: return fail("Expected string");
+        }
+    }
+    ++pos;
+    return true;
+}
+
+bool JsonRequestParser::fail(const char* message) {
+    errorMessage = message;
+    return false;
+}
+
+void JsonRequestParser::skipWhitespace() {
+    while (pos < input.size()) {
+        char c = input[pos];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        ++pos;
+    }
+}
+
+void JsonRequestParser::resolvePending(ConversionRequestFields* items) {
+    if (pending.empty()) {
+        return;
+    }
+
+    // Reserve up front: decoded strings never grow, so the views stay valid
+    size_t total = 0;
+    for (const auto& p : pending) {
+        total += p.text.size();
+    }
+    scratch.clear();
+    scratch.reserve(total);
+
+    for (const auto& p : pending) {
+        size_t offset = scratch.size();
+        appendUnescaped(scratch, p.text);
+        std::string_view decoded(scratch.data() + offset, scratch.size() - offset);
+        if (p.isMode) {
+            items[p.item].mode = decoded;
+        } else {
+            items[p.item].binary = decoded;
+        }
+    }
+}
+
+void appendJsonEscaped(std::string& out, std::string_view text) {
+    static const char kHex[] = "0123456789abcdef";
+    size_t runStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        out.append(text.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 0xF];
+                break;
+        }
+    }
+    out.append(text.data() + runStart, text.size() - runStart);
+}
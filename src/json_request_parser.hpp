@@ -0,0 +1,82 @@
+#ifndef JSON_REQUEST_PARSER_HPP
+#define JSON_REQUEST_PARSER_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Fields of a {"binary": ..., "mode": ...} conversion request. The views
+// point into the request body, or into the parser's scratch buffer for
+// strings that contained escape sequences, and stay valid until the next
+// parse call on the same parser.
+struct ConversionRequestFields {
+    std::string_view binary = "1010";   // Default value
+    std::string_view mode = "STANDARD";  // Default value
+};
+
+// Single-pass JSON parser for conversion requests.
+//
+// The whole body is validated as JSON (RFC 8259): unknown members are
+// checked and skipped, escapes are decoded, and anything malformed is
+// rejected. Strings without escapes are returned as views into the body,
+// and the scratch buffer is reused across calls, so a long-lived parser
+// does not allocate in the steady state.
+class JsonRequestParser {
+public:
+    // Parse a single request object
+    bool parseRequest(std::string_view body, ConversionRequestFields& request);
+
+    // Parse {"items": [request, ...]} holding at most maxItems requests
+    bool parseBatch(std::string_view body, std::vector<ConversionRequestFields>& items,
+                    size_t maxItems);
+    bool parseBatch(std::string_view body, std::pmr::vector<ConversionRequestFields>& items,
+                    size_t maxItems);
+
+    // Reason for the last failure
+    const char* error() const { return errorMessage; }
+
+    // True if the last parseBatch failed only because of maxItems
+    bool tooManyItems() const { return itemLimitExceeded; }
+
+private:
+    // A string value as it appears in the body, before unescaping
+    struct RawString {
+        std::string_view text;
+        bool escaped = false;
+    };
+
+    // Escaped field waiting for its decoded copy in scratch
+    struct PendingString {
+        size_t item;
+        bool isMode;
+        std::string_view text;
+    };
+
+    template <typename Items>
+    bool parseItems(std::string_view body, Items& items, size_t maxItems);
+    bool parseRequestObject(ConversionRequestFields& request, size_t item);
+    bool parseString(RawString& value);
+    bool skipValue(int depth);
+    bool skipNumber();
+    bool skipLiteral(std::string_view literal);
+    bool expect(char c);
+    bool fail(const char* message);
+    void skipWhitespace();
+    bool atEnd() const { return pos >= input.size(); }
+    void resolvePending(ConversionRequestFields* items);
+
+    std::string_view input;
+    size_t pos = 0;
+    const char* errorMessage = "";
+    bool itemLimitExceeded = false;
+
+    std::vector<PendingString> pending;
+    std::string scratch;
+};
+
+// Append `text` to `out` as the contents of a JSON string literal
+void appendJsonEscaped(std::string& out, std::string_view text);
+
+#endif // JSON_REQUEST_PARSER_HPP
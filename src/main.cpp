@@ -1,6 +1,28 @@
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <vector>
+#include "cache_hierarchy.hpp"
+#include "checkpoint.hpp"
+#include "conversion_engine.hpp"
+#include "execution_trace.hpp"
+#include "fixed_width_conversion.hpp"
+#include "mapped_file.hpp"
+#include "multi_core_simulator.hpp"
+#include "packed_bits.hpp"
 #include "processor_simulator.hpp"
+#include "stream_converter.hpp"
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 void demonstrateConversionModes() {
     ProcessorSimulator simulator;
@@ -55,8 +77,391 @@ void demonstrateProcessorState() {
     }
 }
 
+// When stdin is a regular file, counts the bits left in it (whitespace
+// excluded) and rewinds it; nullopt for pipes and terminals
+std::optional<uint64_t> countStdinBits() {
+#ifdef _WIN32
+    return std::nullopt;
+#else
+    struct stat info;
+    if (fstat(STDIN_FILENO, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return std::nullopt;
+    }
+    off_t start = lseek(STDIN_FILENO, 0, SEEK_CUR);
+    if (start < 0) {
+        return std::nullopt;
+    }
+
+    std::vector<char> buffer(1 << 20);
+    uint64_t bits = 0;
+    ssize_t length;
+    while ((length = read(STDIN_FILENO, buffer.data(), buffer.size())) > 0) {
+        for (ssize_t i = 0; i < length; ++i) {
+            char c = buffer[static_cast<size_t>(i)];
+            bits += c != ' ' && c != '\n' && c != '\r' && c != '\t';
+        }
+    }
+    if (length < 0 || lseek(STDIN_FILENO, start, SEEK_SET) != start) {
+        throw ProcessorSimulatorException(std::string("Cannot read standard input: ") + std::strerror(errno));
+    }
+    return bits;
+#endif
+}
+
+// Convert an unbounded bitstream from stdin to stdout in constant memory.
+// A file redirected to stdin gives the same digits as binaryToHex; from a
+// pipe the length is unknown, so digits are grouped from the first bit and
+// a trailing partial group becomes the last digit (10101 gives A1, not 15).
+void streamStdinToStdout() {
+    std::ios::sync_with_stdio(false);
+
+    StreamingHexConverter converter(std::cout);
+    converter.setIgnoreWhitespace(true);
+    if (std::optional<uint64_t> bits = countStdinBits()) {
+        converter.setTotalBits(*bits);
+    }
+
+    std::vector<char> buffer(1 << 20);
+    while (std::cin.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || std::cin.gcount() > 0) {
+        converter.push(std::string_view(buffer.data(), static_cast<size_t>(std::cin.gcount())));
+    }
+    converter.finish();
+    std::cout << '\n';
+}
+
+// Convert a file of ASCII bits into a file of hex digits. Both files are
+// memory-mapped and converted in parallel without intermediate copies.
+void convertFile(const std::string& inputPath, const std::string& outputPath) {
+    MappedFile input(inputPath);
+    std::string_view bits(input.data(), input.size());
+    while (!bits.empty() && (bits.back() == '\n' || bits.back() == '\r' ||
+                             bits.back() == ' ' || bits.back() == '\t')) {
+        bits.remove_suffix(1);
+    }
+
+    size_t digits = ConversionEngine::hexLength(bits.size());
+    MappedOutputFile output(outputPath, digits + 1);
+    try {
+        ProcessorSimulator simulator;
+        simulator.multiThreadedBinaryToHex(bits, output.data());
+    } catch (...) {
+        output.discard();
+        throw;
+    }
+    output.data()[digits] = '\n';
+}
+
+// Convert a raw file of packed MSB-first bytes into a file of hex digits
+// without expanding it to ASCII bits first
+void convertPackedFile(const std::string& inputPath, const std::string& outputPath) {
+    MappedFile input(inputPath);
+    size_t bitCount = input.size() * 8;
+    std::vector<uint64_t> words(PackedBits::wordCount(bitCount));
+    PackedBits::packBytes(reinterpret_cast<const unsigned char*>(input.data()), bitCount, words.data());
+
+    size_t digits = ConversionEngine::hexLength(bitCount);
+    MappedOutputFile output(outputPath, digits + 1);
+    PackedBits::toHex(words.data(), bitCount, output.data());
+    output.data()[digits] = '\n';
+}
+
+// Convert a file of hex digits back into a file of ASCII bits
+void reverseConvertFile(const std::string& inputPath, const std::string& outputPath) {
+    MappedFile input(inputPath);
+    std::string_view hex(input.data(), input.size());
+    while (!hex.empty() && (hex.back() == '\n' || hex.back() == '\r' ||
+                            hex.back() == ' ' || hex.back() == '\t')) {
+        hex.remove_suffix(1);
+    }
+
+    size_t bits = hex.size() * 4;
+    MappedOutputFile output(outputPath, bits + 1);
+    if (!ConversionEngine::hexToBinary(hex.data(), hex.size(), output.data())) {
+        output.discard();
+        throw ProcessorSimulatorException("Invalid hex input: must contain only 0-9 and A-F");
+    }
+    output.data()[bits] = '\n';
+}
+
+// Print the PC and registers in hex
+void printState(const ProcessorSimulator::ProcessorState& state) {
+    using RegisterHex = FixedWidthConverter<ConversionMode::UNSIGNED, 64>;
+    char digits[RegisterHex::kMaxOutputLength];
+    std::cout << "PC: 0x" << std::string(digits, RegisterHex::format(state.getPc(), digits)) << "\n";
+    for (size_t i = 0; i < InstructionSet::kRegisterCount; ++i) {
+        std::cout << InstructionSet::registerName(i) << ": 0x"
+                  << std::string(digits, RegisterHex::format(state.readRegister(i), digits)) << "\n";
+    }
+}
+
+std::string readSource(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw ProcessorSimulatorException("Cannot open " + path);
+    }
+    std::stringstream source;
+    source << file.rdbuf();
+    return source.str();
+}
+
+// Assemble and run a program file, then print the registers
+void runProgram(const std::string& path, uint64_t maxSteps) {
+    ProcessorSimulator simulator;
+    simulator.loadProgram(readSource(path));
+    uint64_t steps = simulator.run(maxSteps);
+
+    const ProcessorSimulator::ProcessorState& state = simulator.getState();
+    std::cout << "Executed " << steps << " instructions"
+              << (state.isHalted() ? " (halted)" : "") << "\n";
+    printState(state);
+}
+
+// Run a program file for `steps` instructions and save a checkpoint to resume from
+void checkpointProgram(const std::string& path, uint64_t steps, const std::string& checkpointPath) {
+    ProcessorSimulator simulator;
+    simulator.loadProgram(readSource(path));
+    uint64_t executed = simulator.run(steps);
+    simulator.checkpoint().save(checkpointPath);
+    std::cout << "Saved checkpoint after " << executed << " instructions to " << checkpointPath << "\n";
+}
+
+// Continue a run from a saved checkpoint, then print the registers
+void resumeCheckpoint(const std::string& checkpointPath, uint64_t maxSteps) {
+    ProcessorSimulator simulator;
+    simulator.restore(Checkpoint::load(checkpointPath));
+    uint64_t steps = simulator.run(maxSteps);
+
+    const ProcessorSimulator::ProcessorState& state = simulator.getState();
+    std::cout << "Executed " << steps << " more instructions"
+              << (state.isHalted() ? " (halted)" : "") << "\n";
+    printState(state);
+}
+
+// Run a program file while recording every step into a trace file
+void traceProgram(const std::string& path, const std::string& tracePath, uint64_t maxSteps) {
+    ProcessorSimulator simulator;
+    simulator.loadProgram(readSource(path));
+    TraceWriter writer(tracePath);
+    simulator.setTrace(&writer);
+    uint64_t steps = simulator.run(maxSteps);
+    simulator.setTrace(nullptr);
+    writer.close();
+
+    std::cout << "Recorded " << steps << " instructions"
+              << (simulator.getState().isHalted() ? " (halted)" : "") << " to " << tracePath << "\n";
+}
+
+// Print the state a traced run was in after `step` instructions
+void replayTrace(const std::string& tracePath, uint64_t step) {
+    TraceReader reader(tracePath);
+    std::cout << "Step " << step << " of " << reader.stepCount() << "\n";
+    printState(reader.stateAt(step));
+}
+
+// Cache levels from PROCESSOR_CACHE_LEVELS (see CacheHierarchy::parseLevels), else the defaults
+CacheHierarchy cacheModelFromEnvironment() {
+    const char* levels = std::getenv("PROCESSOR_CACHE_LEVELS");
+    return levels != nullptr ? CacheHierarchy(CacheHierarchy::parseLevels(levels)) : CacheHierarchy();
+}
+
+void printCacheStats(const CacheHierarchy& caches) {
+    const CacheHierarchy::Stats& stats = caches.getStats();
+    std::cout << "Loads: " << stats.loads << ", stores: " << stats.stores << "\n";
+    for (size_t i = 0; i < caches.levelCount(); ++i) {
+        const CacheHierarchy::LevelStats& level = stats.levels[i];
+        std::cout << caches.levelConfig(i).name << ": " << level.hits << " hits, " << level.misses << " misses ("
+                  << level.hitRate() * 100.0 << "% hit rate), " << level.writebacks << " writebacks\n";
+    }
+    std::cout << "DRAM: " << stats.dramAccesses << " accesses\n";
+}
+
+// Run a program file with every load and store through the cache model
+void runWithCaches(const std::string& path, uint64_t maxSteps) {
+    CacheHierarchy caches = cacheModelFromEnvironment();
+    ProcessorSimulator simulator;
+    simulator.loadProgram(readSource(path));
+    simulator.setCacheModel(&caches);
+    uint64_t steps = simulator.run(maxSteps);
+    simulator.setCacheModel(nullptr);
+
+    const CacheHierarchy::Stats& stats = caches.getStats();
+    std::cout << "Executed " << steps << " instructions"
+              << (simulator.getState().isHalted() ? " (halted)" : "") << " in an estimated " << stats.cycles
+              << " cycles (CPI " << stats.cyclesPerInstruction() << ")\n";
+    printCacheStats(caches);
+}
+
+// Estimate the cycles of a long run from detailed windows between fast-forwarded stretches
+void runSampled(const std::string& path, const SamplingPlan& plan, uint64_t maxSteps) {
+    CacheHierarchy caches = cacheModelFromEnvironment();
+    ProcessorSimulator simulator;
+    simulator.loadProgram(readSource(path));
+
+    auto started = std::chrono::steady_clock::now();
+    SampledRun run = simulator.runSampled(caches, plan, maxSteps);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    std::cout << "Executed " << run.instructions << " instructions"
+              << (simulator.getState().isHalted() ? " (halted)" : "") << " in " << elapsed.count() << " s, "
+              << run.detailedInstructions << " of them in " << run.windows << " detailed windows\n";
+    std::cout << "Estimated " << run.estimatedCycles << " cycles (CPI " << run.cyclesPerInstruction << ")\n";
+    printCacheStats(caches);
+}
+
+// Run a program file on `coreCount` cores sharing one memory; R1 holds each core's index
+void runCores(size_t coreCount, const std::string& path, uint64_t maxSteps) {
+    MultiCoreSimulator simulator;
+    simulator.addCores(coreCount, readSource(path));
+    for (size_t i = 0; i < coreCount; ++i) {
+        simulator.core(i).state.writeRegister(1, i);
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    uint64_t steps = simulator.run(maxSteps);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    size_t halted = 0;
+    size_t faulted = 0;
+    for (size_t i = 0; i < coreCount; ++i) {
+        const MultiCoreSimulator::Core& core = simulator.core(i);
+        if (!core.fault.empty()) {
+            ++faulted;
+            std::cerr << "Core " << i << ": " << core.fault << "\n";
+        } else if (core.state.isHalted()) {
+            ++halted;
+        }
+    }
+    std::cout << "Executed " << steps << " instructions on " << coreCount << " cores in "
+              << simulator.getEpochs() << " epochs (" << halted << " halted, " << faulted << " faulted)\n";
+    if (elapsed.count() > 0) {
+        std::cout << "Throughput: " << static_cast<double>(steps) / elapsed.count() / 1e6 << " MIPS\n";
+    }
+}
+
 int main(int argc, char* argv[]) {
     try {
+        // Stream mode: processor_simulator --stream < bits.txt > hex.txt
+        if (argc > 1 && std::string(argv[1]) == "--stream") {
+            streamStdinToStdout();
+            return 0;
+        }
+
+        // File mode: processor_simulator --file bits.txt hex.txt
+        if (argc > 1 && std::string(argv[1]) == "--file") {
+            if (argc != 4) {
+                std::cerr << "Usage: " << argv[0] << " --file <input> <output>" << std::endl;
+                return 1;
+            }
+            convertFile(argv[2], argv[3]);
+            return 0;
+        }
+
+        // Packed mode: processor_simulator --packed bits.bin hex.txt
+        if (argc > 1 && std::string(argv[1]) == "--packed") {
+            if (argc != 4) {
+                std::cerr << "Usage: " << argv[0] << " --packed <input> <output>" << std::endl;
+                return 1;
+            }
+            convertPackedFile(argv[2], argv[3]);
+            return 0;
+        }
+
+        // Reverse mode: processor_simulator --reverse hex.txt bits.txt
+        if (argc > 1 && std::string(argv[1]) == "--reverse") {
+            if (argc != 4) {
+                std::cerr << "Usage: " << argv[0] << " --reverse <input> <output>" << std::endl;
+                return 1;
+            }
+            reverseConvertFile(argv[2], argv[3]);
+            return 0;
+        }
+
+        // Program mode: processor_simulator --run program.asm [max-steps]
+        if (argc > 1 && std::string(argv[1]) == "--run") {
+            if (argc != 3 && argc != 4) {
+                std::cerr << "Usage: " << argv[0] << " --run <program> [max-steps]" << std::endl;
+                return 1;
+            }
+            runProgram(argv[2], argc == 4 ? std::stoull(argv[3]) : std::numeric_limits<uint64_t>::max());
+            return 0;
+        }
+
+        // Checkpoint mode: processor_simulator --checkpoint program.asm 1000000 run.ckpt
+        if (argc > 1 && std::string(argv[1]) == "--checkpoint") {
+            if (argc != 5) {
+                std::cerr << "Usage: " << argv[0] << " --checkpoint <program> <steps> <checkpoint-file>" << std::endl;
+                return 1;
+            }
+            checkpointProgram(argv[2], std::stoull(argv[3]), argv[4]);
+            return 0;
+        }
+
+        // Resume mode: processor_simulator --resume run.ckpt [max-steps]
+        if (argc > 1 && std::string(argv[1]) == "--resume") {
+            if (argc != 3 && argc != 4) {
+                std::cerr << "Usage: " << argv[0] << " --resume <checkpoint-file> [max-steps]" << std::endl;
+                return 1;
+            }
+            resumeCheckpoint(argv[2], argc == 4 ? std::stoull(argv[3]) : std::numeric_limits<uint64_t>::max());
+            return 0;
+        }
+
+        // Trace mode: processor_simulator --trace program.asm run.trace [max-steps]
+        if (argc > 1 && std::string(argv[1]) == "--trace") {
+            if (argc != 4 && argc != 5) {
+                std::cerr << "Usage: " << argv[0] << " --trace <program> <trace-file> [max-steps]" << std::endl;
+                return 1;
+            }
+            traceProgram(argv[2], argv[3], argc == 5 ? std::stoull(argv[4]) : std::numeric_limits<uint64_t>::max());
+            return 0;
+        }
+
+        // Replay mode: processor_simulator --replay run.trace 1000000
+        if (argc > 1 && std::string(argv[1]) == "--replay") {
+            if (argc != 4) {
+                std::cerr << "Usage: " << argv[0] << " --replay <trace-file> <step>" << std::endl;
+                return 1;
+            }
+            replayTrace(argv[2], std::stoull(argv[3]));
+            return 0;
+        }
+
+        // Multi-core mode: processor_simulator --cores 256 program.asm [max-steps-per-core]
+        if (argc > 1 && std::string(argv[1]) == "--cores") {
+            if (argc != 4 && argc != 5) {
+                std::cerr << "Usage: " << argv[0] << " --cores <count> <program> [max-steps-per-core]" << std::endl;
+                return 1;
+            }
+            runCores(std::stoull(argv[2]), argv[3],
+                     argc == 5 ? std::stoull(argv[4]) : std::numeric_limits<uint64_t>::max());
+            return 0;
+        }
+
+        // Cache mode: processor_simulator --cache program.asm [max-steps]
+        if (argc > 1 && std::string(argv[1]) == "--cache") {
+            if (argc != 3 && argc != 4) {
+                std::cerr << "Usage: " << argv[0] << " --cache <program> [max-steps]" << std::endl;
+                return 1;
+            }
+            runWithCaches(argv[2], argc == 4 ? std::stoull(argv[3]) : std::numeric_limits<uint64_t>::max());
+            return 0;
+        }
+
+        // Sampled mode: processor_simulator --sample program.asm 10000000 100000 100000 [max-steps]
+        if (argc > 1 && std::string(argv[1]) == "--sample") {
+            if (argc != 6 && argc != 7) {
+                std::cerr << "Usage: " << argv[0] << " --sample <program> <fast-forward> <warmup> <window> [max-steps]"
+                          << std::endl;
+                return 1;
+            }
+            SamplingPlan plan;
+            plan.fastForward = std::stoull(argv[3]);
+            plan.warmup = std::stoull(argv[4]);
+            plan.window = std::stoull(argv[5]);
+            runSampled(argv[2], plan, argc == 7 ? std::stoull(argv[6]) : std::numeric_limits<uint64_t>::max());
+            return 0;
+        }
+
         // Demonstrate conversion modes
         demonstrateConversionModes();
 
@@ -0,0 +1,112 @@
+#include "mapped_file.hpp"
+#include "processor_simulator.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+[[noreturn]] void throwSystemError(const std::string& what, const std::string& path) {
+    throw ProcessorSimulatorException(what + " '" + path + "': " + std::strerror(errno));
+}
+
+} // namespace
+
+#ifndef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throwSystemError("Cannot open", path);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throwSystemError("Cannot stat", path);
+    }
+    length = static_cast<size_t>(info.st_size);
+
+    // mmap rejects empty mappings; an empty file is simply an empty view
+    if (length > 0) {
+        void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throwSystemError("Cannot map", path);
+        }
+        ::madvise(address, length, MADV_SEQUENTIAL);
+        mapping = static_cast<const char*>(address);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (mapping != nullptr) {
+        ::munmap(const_cast<char*>(mapping), length);
+    }
+}
+
+MappedOutputFile::MappedOutputFile(const std::string& path, size_t size)
+    : path(path), length(size) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throwSystemError("Cannot create", path);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        throwSystemError("Cannot resize", path);
+    }
+
+    if (length > 0) {
+        void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (address == MAP_FAILED) {
+            ::close(fd);
+            throwSystemError("Cannot map", path);
+        }
+        mapping = static_cast<char*>(address);
+    }
+    ::close(fd);
+}
+
+MappedOutputFile::~MappedOutputFile() {
+    unmap();
+}
+
+void MappedOutputFile::unmap() {
+    if (mapping != nullptr) {
+        ::munmap(mapping, length);
+        mapping = nullptr;
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    throw ProcessorSimulatorException("Memory-mapped input is not supported on this platform: " + path);
+}
+
+MappedFile::~MappedFile() = default;
+
+MappedOutputFile::MappedOutputFile(const std::string& path, size_t size)
+    : path(path), length(size) {
+    throw ProcessorSimulatorException("Memory-mapped output is not supported on this platform: " + path);
+}
+
+MappedOutputFile::~MappedOutputFile() = default;
+
+void MappedOutputFile::unmap() {}
+
+#endif // _WIN32
+
+void MappedOutputFile::discard() {
+    unmap();
+    std::remove(path.c_str());
+}
@@ -0,0 +1,47 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of an entire file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return mapping; }
+    size_t size() const { return length; }
+
+private:
+    const char* mapping = nullptr;
+    size_t length = 0;
+};
+
+// Writable shared mapping of a file created (or truncated) to a fixed size
+class MappedOutputFile {
+public:
+    MappedOutputFile(const std::string& path, size_t size);
+    ~MappedOutputFile();
+
+    MappedOutputFile(const MappedOutputFile&) = delete;
+    MappedOutputFile& operator=(const MappedOutputFile&) = delete;
+
+    char* data() { return mapping; }
+    size_t size() const { return length; }
+
+    // Unmap and delete the file, e.g. after a failed conversion
+    void discard();
+
+private:
+    void unmap();
+
+    std::string path;
+    char* mapping = nullptr;
+    size_t length = 0;
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,104 @@
+#include "multi_core_simulator.hpp"
+#include "interpreter.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+MultiCoreSimulator::MultiCoreSimulator()
+    : pool(&ThreadPool::shared()) {}
+
+MultiCoreSimulator::MultiCoreSimulator(ThreadPool& pool)
+    : pool(&pool) {}
+
+void MultiCoreSimulator::loadProgram(const Program& program) {
+    uint64_t address = program.base;
+    for (const Instruction& instruction : program.code) {
+        memory.store64(address, instruction.encode());
+        address += InstructionSet::kInstructionBytes;
+    }
+}
+
+size_t MultiCoreSimulator::addCore(std::string_view source, uint64_t base) {
+    return addCores(1, source, base);
+}
+
+size_t MultiCoreSimulator::addCores(size_t count, std::string_view source, uint64_t base) {
+    Program program = InstructionSet::assembleProgram(source, base);
+    loadProgram(program);
+
+    size_t first = cores.size();
+    cores.reserve(first + count);
+    for (size_t i = 0; i < count; ++i) {
+        auto core = std::make_unique<Core>(&memory);
+        core->program = program;
+        core->state.setPc(program.base);
+        cores.push_back(std::move(core));
+    }
+    return first;
+}
+
+void MultiCoreSimulator::setQuantum(uint64_t instructions) {
+    if (instructions == 0) {
+        throw ProcessorSimulatorException("Quantum must be at least one instruction");
+    }
+    quantum = instructions;
+}
+
+size_t MultiCoreSimulator::runningCores() const {
+    return static_cast<size_t>(std::count_if(cores.begin(), cores.end(), [](const std::unique_ptr<Core>& core) {
+        return !core->isStopped();
+    }));
+}
+
+uint64_t MultiCoreSimulator::runEpoch() {
+    return runEpoch(std::numeric_limits<uint64_t>::max());
+}
+
+uint64_t MultiCoreSimulator::runEpoch(uint64_t maxStepsPerCore) {
+    std::vector<Core*> running;
+    running.reserve(cores.size());
+    for (const std::unique_ptr<Core>& core : cores) {
+        if (canRun(*core, maxStepsPerCore)) {
+            running.push_back(core.get());
+        }
+    }
+
+    // The shared memory is read-only until every quantum has finished
+    std::atomic<uint64_t> executed{0};
+    pool->parallelFor(running.size(), 1,
+        [&](size_t begin, size_t end) {
+            uint64_t total = 0;
+            for (size_t i = begin; i < end; ++i) {
+                Core& core = *running[i];
+                uint64_t budget = std::min(quantum, maxStepsPerCore - core.steps);
+                uint64_t steps = 0;
+                try {
+                    Interpreter::run(core.state, core.memory, core.program, core.blocks, budget, steps);
+                } catch (const ProcessorSimulatorException& e) {
+                    core.fault = e.what();
+                }
+                core.steps += steps;
+                total += steps;
+            }
+            executed.fetch_add(total, std::memory_order_relaxed);
+        },
+        parallelism);
+
+    // Synchronization point: publish the stores in core order
+    for (Core* core : running) {
+        core->memory.commitTo(memory);
+    }
+    ++epochs;
+    return executed.load();
+}
+
+uint64_t MultiCoreSimulator::run(uint64_t maxStepsPerCore) {
+    uint64_t executed = 0;
+    while (std::any_of(cores.begin(), cores.end(), [&](const std::unique_ptr<Core>& core) {
+        return canRun(*core, maxStepsPerCore);
+    })) {
+        executed += runEpoch(maxStepsPerCore);
+    }
+    return executed;
+}
@@ -0,0 +1,116 @@
+#ifndef MULTI_CORE_SIMULATOR_HPP
+#define MULTI_CORE_SIMULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "instruction_set.hpp"
+#include "processor_simulator.hpp"
+#include "simulated_memory.hpp"
+
+class ThreadPool;
+
+// Many independent simulated cores sharing one simulated memory.
+//
+// Each core has its own register file, PC, flags and decoded program.
+// Execution proceeds in epochs: every running core executes up to one time
+// quantum of instructions on the thread pool, then all cores meet at a
+// synchronization point where their stores are published. During a quantum
+// a core reads the shared memory as it was at the start of the epoch plus
+// its own stores, which go to a private overlay (see SimulatedMemory). At the
+// synchronization point the overlays are committed in core order, so when
+// two cores store to the same word the higher-numbered core wins. The result
+// of a run therefore does not depend on the number of host threads.
+//
+// A core that executes SYNC ends its quantum early and continues after the
+// next synchronization point, once the stores of every core are visible. A
+// core that faults (illegal instruction, misaligned access, PC outside its
+// program) stops and records the error; the other cores carry on. The
+// instructions it retired before the fault still count as executed.
+//
+// Stores into a core's own program update its decoded copy, but not those of
+// other cores running the same code.
+class MultiCoreSimulator {
+public:
+    static constexpr uint64_t kDefaultQuantum = 10000;
+
+    using State = ProcessorSimulator::ProcessorState;
+
+    // Cache-line aligned so cores on different threads do not share lines
+    struct alignas(64) Core {
+        explicit Core(const SimulatedMemory* shared)
+            : memory(shared) {}
+
+        State state;
+        Program program;
+        SimulatedMemory memory;  // Overlay over the shared memory
+        BlockCache blocks;
+        uint64_t steps = 0;
+        std::string fault;  // Empty unless the core faulted
+
+        bool isStopped() const { return state.isHalted() || !fault.empty(); }
+    };
+
+    // Uses the process-wide thread pool unless one is injected
+    MultiCoreSimulator();
+    explicit MultiCoreSimulator(ThreadPool& pool);
+
+    MultiCoreSimulator(const MultiCoreSimulator&) = delete;
+    MultiCoreSimulator& operator=(const MultiCoreSimulator&) = delete;
+
+    // Assembles `source`, writes it to shared memory at `base` and adds a core
+    // whose PC points at it; returns the core's index. Cores with different
+    // programs need disjoint address ranges.
+    size_t addCore(std::string_view source, uint64_t base = 0);
+
+    // Adds `count` cores running the same program, assembled once
+    size_t addCores(size_t count, std::string_view source, uint64_t base = 0);
+
+    // Runs one epoch: a quantum on every running core, then the synchronization
+    // point. Returns the number of instructions executed.
+    uint64_t runEpoch();
+
+    // Runs epochs until every core has halted or faulted, or has executed
+    // `maxStepsPerCore` instructions; returns the number executed
+    uint64_t run(uint64_t maxStepsPerCore = std::numeric_limits<uint64_t>::max());
+
+    // Throws ProcessorSimulatorException for a quantum of 0
+    void setQuantum(uint64_t instructions);
+    uint64_t getQuantum() const { return quantum; }
+
+    // Maximum threads per epoch (0 = whole pool)
+    void setParallelism(unsigned threads) { parallelism = threads; }
+
+    size_t coreCount() const { return cores.size(); }
+    Core& core(size_t index) { return *cores[index]; }
+    const Core& core(size_t index) const { return *cores[index]; }
+
+    // Cores that have neither halted nor faulted
+    size_t runningCores() const;
+
+    uint64_t getEpochs() const { return epochs; }
+
+    // The shared memory; only modify it between epochs
+    SimulatedMemory& getMemory() { return memory; }
+    const SimulatedMemory& getMemory() const { return memory; }
+
+private:
+    void loadProgram(const Program& program);
+    uint64_t runEpoch(uint64_t maxStepsPerCore);
+    bool canRun(const Core& core, uint64_t maxStepsPerCore) const {
+        return !core.isStopped() && core.steps < maxStepsPerCore;
+    }
+
+    ThreadPool* pool;
+    unsigned parallelism = 0;
+    uint64_t quantum = kDefaultQuantum;
+    uint64_t epochs = 0;
+    SimulatedMemory memory;
+    std::vector<std::unique_ptr<Core>> cores;
+};
+
+#endif // MULTI_CORE_SIMULATOR_HPP
@@ -0,0 +1,185 @@
+#include "packed_bits.hpp"
+#include "conversion_engine.hpp"
+#include "processor_simulator.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace {
+
+constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+// Eight ASCII bits of every byte value, first character = most significant bit
+constexpr std::array<uint64_t, 256> makeByteBits() {
+    std::array<uint64_t, 256> table{};
+    for (int value = 0; value < 256; ++value) {
+        uint64_t chars = 0;
+        for (int bit = 0; bit < 8; ++bit) {
+            uint64_t c = (value & (0x80 >> bit)) ? '1' : '0';
+            chars |= c << (8 * bit);  // Little-endian: character `bit` is byte `bit`
+        }
+        table[value] = chars;
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, 256> kByteBits = makeByteBits();
+
+inline uint64_t loadLittleEndian(const char* bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+inline void storeLittleEndian(char* bytes, uint64_t word) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    std::memcpy(bytes, &word, sizeof(word));
+}
+
+inline unsigned digitValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return static_cast<unsigned>(c - '0');
+    }
+    c = static_cast<char>(c | 0x20);
+    return c >= 'a' && c <= 'f' ? static_cast<unsigned>(c - 'a' + 10) : 0xFF;
+}
+
+[[noreturn]] void throwInvalid(const char* what) {
+    throw ProcessorSimulatorException(std::string("Invalid ") + what + " input");
+}
+
+} // namespace
+
+PackedBits::PackedBits(size_t bitCount)
+    : words(wordCount(bitCount), 0), bitCount(bitCount) {}
+
+bool PackedBits::packAscii(const char* bits, size_t count, uint64_t* words) {
+    uint64_t invalid = 0;
+    size_t w = 0;
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = 0;
+        for (size_t b = 0; b < 64; b += 8) {
+            uint64_t chars = loadLittleEndian(bits + i + b);
+            invalid |= (chars & 0xFEFEFEFEFEFEFEFEULL) ^ 0x3030303030303030ULL;
+            // Gather bit 0 of every byte into one byte, first character first
+            word = word << 8 | ((chars & 0x0101010101010101ULL) * 0x8040201008040201ULL) >> 56;
+        }
+        words[w++] = word;
+    }
+    if (i < count) {
+        uint64_t word = 0;
+        for (size_t b = 0; i + b < count; ++b) {
+            auto bit = static_cast<unsigned char>(bits[i + b]) - static_cast<unsigned>('0');
+            invalid |= bit & ~1u;
+            word |= static_cast<uint64_t>(bit & 1) << (63 - b);
+        }
+        words[w] = word;
+    }
+    return invalid == 0;
+}
+
+void PackedBits::unpackAscii(const uint64_t* words, size_t count, char* out) {
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t word = words[i / 64];
+        for (size_t b = 0; b < 64; b += 8) {
+            storeLittleEndian(out + i + b, kByteBits[(word >> (56 - b)) & 0xFF]);
+        }
+    }
+    for (; i < count; ++i) {
+        out[i] = ((words[i / 64] >> (63 - i % 64)) & 1) ? '1' : '0';
+    }
+}
+
+void PackedBits::packBytes(const unsigned char* bytes, size_t count, uint64_t* words) {
+    size_t byteCount = (count + 7) / 8;
+    for (size_t w = 0; w * 8 < byteCount; ++w) {
+        // Big-endian load; compilers turn the full-word case into one byte swap
+        size_t wordBytes = byteCount - w * 8 < 8 ? byteCount - w * 8 : 8;
+        uint64_t word = 0;
+        for (size_t b = 0; b < 8; ++b) {
+            word = word << 8 | (b < wordBytes ? bytes[w * 8 + b] : 0);
+        }
+        words[w] = word;
+    }
+    // Bits past `count` in the last byte are not part of the stream
+    if (count % 64 != 0) {
+        words[count / 64] &= ~uint64_t{0} << (64 - count % 64);
+    }
+}
+
+void PackedBits::toHex(const uint64_t* words, size_t count, char* out) {
+    // Prepend `pad` zero bits so every digit covers one aligned nibble of the
+    // shifted stream; each shifted word is a funnel shift of two input words
+    size_t pad = (4 - count % 4) % 4;
+    size_t digits = ConversionEngine::hexLength(count);
+    size_t inputWords = wordCount(count);
+
+    uint64_t previous = 0;
+    for (size_t w = 0; w * 16 < digits; ++w) {
+        uint64_t current = w < inputWords ? words[w] : 0;
+        uint64_t shifted = pad == 0 ? current : previous << (64 - pad) | current >> pad;
+        previous = current;
+
+        size_t wordDigits = digits - w * 16 < 16 ? digits - w * 16 : 16;
+        char* wordOut = out + w * 16;
+        for (size_t d = 0; d < wordDigits; ++d) {
+            wordOut[d] = kHexDigits[(shifted >> (60 - 4 * d)) & 0xF];
+        }
+    }
+}
+
+bool PackedBits::fromHex(const char* hex, size_t digitCount, uint64_t* words) {
+    unsigned invalid = 0;
+    for (size_t w = 0; w * 16 < digitCount; ++w) {
+        size_t wordDigits = digitCount - w * 16 < 16 ? digitCount - w * 16 : 16;
+        uint64_t word = 0;
+        for (size_t d = 0; d < wordDigits; ++d) {
+            unsigned value = digitValue(hex[w * 16 + d]);
+            invalid |= value & ~0xFu;
+            word = word << 4 | (value & 0xF);
+        }
+        words[w] = word << (4 * (16 - wordDigits));
+    }
+    return invalid == 0;
+}
+
+PackedBits PackedBits::fromAscii(std::string_view bits) {
+    PackedBits packed(bits.size());
+    if (!packAscii(bits.data(), bits.size(), packed.data())) {
+        throwInvalid("binary");
+    }
+    return packed;
+}
+
+PackedBits PackedBits::fromHexString(std::string_view hex) {
+    PackedBits packed(hex.size() * 4);
+    if (!fromHex(hex.data(), hex.size(), packed.data())) {
+        throwInvalid("hex");
+    }
+    return packed;
+}
+
+PackedBits PackedBits::fromBytes(const void* data, size_t bitCount) {
+    PackedBits packed(bitCount);
+    packBytes(static_cast<const unsigned char*>(data), bitCount, packed.data());
+    return packed;
+}
+
+std::string PackedBits::toAsciiString() const {
+    std::string bits(bitCount, '\0');
+    unpackAscii(words.data(), bitCount, &bits[0]);
+    return bits;
+}
+
+std::string PackedBits::toHexString() const {
+    std::string hex(ConversionEngine::hexLength(bitCount), '\0');
+    toHex(words.data(), bitCount, &hex[0]);
+    return hex;
+}
@@ -0,0 +1,63 @@
+#ifndef PACKED_BITS_HPP
+#define PACKED_BITS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A bitstream packed 64 bits per uint64_t word, one eighth the size of the
+// ASCII '0'/'1' form.
+//
+// Bit i of the stream (the i-th ASCII character) is bit 63 - i % 64 of word
+// i / 64, so each word holds its bits most significant first and the unused
+// low bits of the last word are zero. Written out big-endian word by word,
+// this is the plain MSB-first byte layout accepted by the server and CLI.
+//
+// The static kernels convert between ASCII bits, packed words and hex
+// digits directly in caller-provided buffers; the owning helpers wrap them.
+class PackedBits {
+public:
+    PackedBits() = default;
+
+    // `bitCount` zero bits
+    explicit PackedBits(size_t bitCount);
+
+    static size_t wordCount(size_t bitCount) { return (bitCount + 63) / 64; }
+
+    // `count` ASCII bits into wordCount(count) words; false on a character other than '0'/'1'
+    static bool packAscii(const char* bits, size_t count, uint64_t* words);
+
+    // The first `count` bits as ASCII '0'/'1'
+    static void unpackAscii(const uint64_t* words, size_t count, char* out);
+
+    // `count` bits of MSB-first bytes into wordCount(count) words
+    static void packBytes(const unsigned char* bytes, size_t count, uint64_t* words);
+
+    // The first `count` bits as hexLength(count) digits; like binaryToHex, a
+    // partial leading group becomes a zero-padded first digit
+    static void toHex(const uint64_t* words, size_t count, char* out);
+
+    // `digitCount` hex digits into 4 * digitCount bits; false on a non-hex character
+    static bool fromHex(const char* hex, size_t digitCount, uint64_t* words);
+
+    // Owning conversions; invalid input throws ProcessorSimulatorException
+    static PackedBits fromAscii(std::string_view bits);
+    static PackedBits fromHexString(std::string_view hex);
+    static PackedBits fromBytes(const void* data, size_t bitCount);
+
+    std::string toAsciiString() const;
+    std::string toHexString() const;
+
+    size_t size() const { return bitCount; }
+    const uint64_t* data() const { return words.data(); }
+    uint64_t* data() { return words.data(); }
+    bool bit(size_t index) const { return (words[index / 64] >> (63 - index % 64)) & 1; }
+
+private:
+    std::vector<uint64_t> words;
+    size_t bitCount = 0;
+};
+
+#endif // PACKED_BITS_HPP
@@ -1,176 +1,380 @@
 #include "processor_simulator.hpp"
+#include "cache_hierarchy.hpp"
+#include "checkpoint.hpp"
+#include "conversion_engine.hpp"
+#include "fixed_width_conversion.hpp"
+#include "interpreter.hpp"
+#include "thread_pool.hpp"
 
-bool ProcessorSimulator::validateBinaryInput(const std::string& binaryStr) {
-    // Check if the input contains only 0s and 1s
-    return std::all_of(binaryStr.begin(), binaryStr.end(), [](char c) {
-        return c == '0' || c == '1';
-    });
-}
+#include <atomic>
+#include <cstring>
+
+namespace {
 
-std::string ProcessorSimulator::binaryToHex(const std::string& binaryStr, ConversionMode mode) {
-    // Validate input first
-    if (!validateBinaryInput(binaryStr)) {
-        throw ProcessorSimulatorException("Invalid binary input: must contain only 0s and 1s");
+// Specialised kernels for register-sized inputs, indexed by [mode][width]
+using FixedWidthKernel = size_t (*)(const char* bits, char* out);
+constexpr size_t kFixedWidthOutputCapacity =
+    FixedWidthConverter<ConversionMode::FLOATING_POINT, 64>::kMaxOutputLength;
+
+template <ConversionMode Mode>
+constexpr FixedWidthKernel kFixedWidthRow[4] = {
+    FixedWidthConverter<Mode, 8>::convert,
+    FixedWidthConverter<Mode, 16>::convert,
+    FixedWidthConverter<Mode, 32>::convert,
+    FixedWidthConverter<Mode, 64>::convert,
+};
+
+const FixedWidthKernel* const kFixedWidthKernels[] = {
+    kFixedWidthRow<ConversionMode::STANDARD>,
+    kFixedWidthRow<ConversionMode::SIGNED>,
+    kFixedWidthRow<ConversionMode::UNSIGNED>,
+    kFixedWidthRow<ConversionMode::FLOATING_POINT>,
+};
+
+// Kernel for an input of `bitCount` bits, or nullptr if there is none
+FixedWidthKernel fixedWidthKernel(ConversionMode mode, size_t bitCount) {
+    size_t column;
+    switch (bitCount) {
+        case 8: column = 0; break;
+        case 16: column = 1; break;
+        case 32: column = 2; break;
+        case 64: column = 3; break;
+        default: return nullptr;
     }
+    return kFixedWidthKernels[static_cast<size_t>(mode)][column];
+}
+
+[[noreturn]] void throwInvalidBinary() {
+    throw ProcessorSimulatorException("Invalid binary input: must contain only 0s and 1s");
+}
 
-    // Pad the binary string to ensure it's a multiple of 4
-    std::string paddedBinary = binaryStr;
-    while (paddedBinary.length() % 4 != 0) {
-        paddedBinary = '0' + paddedBinary;
+// Output length of a SIGNED conversion, see signedBinaryToHex
+size_t signedHexLength(std::string_view bits) {
+    if (bits.empty()) {
+        return 0;
+    }
+    if (bits[0] == '1') {
+        return (bits.size() + 31) / 32 * 8;
     }
+    size_t first = bits.find_first_not_of('0');
+    return first == std::string_view::npos ? 1 : ConversionEngine::hexLength(bits.size() - first);
+}
 
-    std::stringstream hexStream;
-    hexStream << std::hex << std::uppercase;
+// Two's-complement value of any width, converted digit-wise without
+// arithmetic: a negative value is the input sign-extended with 1 bits to the
+// next multiple of 32 bits, a non-negative one the input without its leading
+// zeros. Writes signedHexLength(bits) characters to `out`;
+// `convertDigits(bits, out)` writes hexLength(bits.size()) digits.
+template <typename ConvertDigits>
+void signedBinaryToHex(std::string_view bits, char* out, ConvertDigits convertDigits) {
+    if (bits.empty()) {
+        return;
+    }
 
-    // Handle different conversion modes
-    switch (mode) {
-        case ConversionMode::STANDARD:
-            // Standard conversion
-            for (size_t i = 0; i < paddedBinary.length(); i += 4) {
-                std::string chunk = paddedBinary.substr(i, 4);
-                unsigned long decimal = std::bitset<4>(chunk).to_ulong();
-                hexStream << decimal;
-            }
-            break;
-
-        case ConversionMode::SIGNED: {
-            // Signed integer conversion (2's complement)
-            bool isNegative = paddedBinary[0] == '1';
-            if (isNegative) {
-                // Convert 2's complement to decimal
-                std::bitset<64> bits(paddedBinary);
-                int64_t signedDecimal = static_cast<int64_t>(bits.to_ulong());
-                hexStream << std::hex << signedDecimal;
-            } else {
-                // Positive number conversion remains the same
-                for (size_t i = 0; i < paddedBinary.length(); i += 4) {
-                    std::string chunk = paddedBinary.substr(i, 4);
-                    unsigned long decimal = std::bitset<4>(chunk).to_ulong();
-                    hexStream << decimal;
-                }
-            }
-            break;
+    if (bits[0] == '0') {
+        size_t first = bits.find_first_not_of('0');
+        if (first == std::string_view::npos) {
+            out[0] = '0';
+            return;
         }
+        bits.remove_prefix(first);
+        convertDigits(bits, out);
+        return;
+    }
+    if (bits[0] != '1') {
+        throwInvalidBinary();
+    }
 
-        case ConversionMode::UNSIGNED:
-            // Unsigned integer conversion
-            for (size_t i = 0; i < paddedBinary.length(); i += 4) {
-                std::string chunk = paddedBinary.substr(i, 4);
-                unsigned long decimal = std::bitset<4>(chunk).to_ulong();
-                hexStream << decimal;
-            }
-            break;
+    size_t width = (bits.size() + 31) / 32 * 32;
+    size_t digitCount = ConversionEngine::hexLength(bits.size());
+    std::fill(out, out + width / 4 - digitCount, 'F');
+    char* digits = out + width / 4 - digitCount;
+    convertDigits(bits, digits);
 
-        case ConversionMode::FLOATING_POINT:
-            // IEEE 754 floating-point conversion (simplified)
-            // Note: This is a basic implementation and doesn't cover all floating-point nuances
-            std::bitset<32> bits(paddedBinary);
-            float floatValue = *reinterpret_cast<float*>(&bits);
-            hexStream << std::hex << std::scientific << floatValue;
-            break;
+    // The engine left-pads a partial leading group with zeros; they are sign bits
+    size_t leading = bits.size() % 4;
+    if (leading != 0) {
+        static const char kHexDigits[] = "0123456789ABCDEF";
+        unsigned value = static_cast<unsigned>(digits[0] - '0');
+        digits[0] = kHexDigits[value | (0xFu << leading & 0xFu)];
     }
+}
 
-    return hexStream.str();
+// IEEE binary16/32/64 by width; narrower inputs are zero-extended to binary32.
+// Writes at most kFixedWidthOutputCapacity characters.
+size_t floatingPointBinaryToHex(std::string_view bits, char* out) {
+    if (bits.size() > 32) {
+        throw ProcessorSimulatorException(
+            "Invalid floating-point input: expected 16, 32 or 64 bits (or at most 32 bits)");
+    }
+    uint64_t value = 0;
+    for (char c : bits) {
+        if (c != '0' && c != '1') {
+            throwInvalidBinary();
+        }
+        value = value << 1 | static_cast<uint64_t>(c - '0');
+    }
+    return FixedWidthConverter<ConversionMode::FLOATING_POINT, 32>::format(value, out);
 }
 
-std::string ProcessorSimulator::multiThreadedBinaryToHex(const std::string& binaryStr, ConversionMode mode) {
-    // Validate input first
-    if (!validateBinaryInput(binaryStr)) {
-        throw ProcessorSimulatorException("Invalid binary input: must contain only 0s and 1s");
+// Conversion in any mode into `out`, with digit-wise runs of the input going
+// through `convertDigits`. Returns the output length and writes nothing if
+// it exceeds `capacity`.
+template <typename ConvertDigits>
+size_t convertInto(std::string_view bits, ConversionMode mode, char* out, size_t capacity,
+                   ConvertDigits convertDigits) {
+    // Register-sized inputs and floating-point values are formatted on the stack first
+    char buffer[kFixedWidthOutputCapacity];
+    size_t length;
+    if (FixedWidthKernel kernel = fixedWidthKernel(mode, bits.size())) {
+        length = kernel(bits.data(), buffer);
+        if (length == 0) {
+            throwInvalidBinary();
+        }
+    } else if (mode == ConversionMode::FLOATING_POINT) {
+        length = floatingPointBinaryToHex(bits, buffer);
+    } else if (mode == ConversionMode::SIGNED) {
+        length = signedHexLength(bits);
+        if (length <= capacity) {
+            signedBinaryToHex(bits, out, convertDigits);
+        }
+        return length;
+    } else {
+        // Digit-wise modes go straight through the conversion engine
+        length = ConversionEngine::hexLength(bits.size());
+        if (length <= capacity) {
+            convertDigits(bits, out);
+        }
+        return length;
     }
 
-    // Pad the binary string to ensure it's a multiple of 4
-    std::string paddedBinary = binaryStr;
-    while (paddedBinary.length() % 4 != 0) {
-        paddedBinary = '0' + paddedBinary;
+    if (length <= capacity) {
+        std::memcpy(out, buffer, length);
     }
+    return length;
+}
 
-    // Determine number of threads based on hardware concurrency
-    unsigned int numThreads = std::thread::hardware_concurrency();
-    if (numThreads == 0) numThreads = 4;  // Default to 4 threads if detection fails
+void convertDigitsOrThrow(std::string_view bits, char* out) {
+    if (!ConversionEngine::binaryToHex(bits.data(), bits.size(), out)) {
+        throwInvalidBinary();
+    }
+}
 
-    size_t chunkSize = paddedBinary.length() / numThreads;
-    std::vector<std::string> results(numThreads);
-    std::vector<std::thread> threads;
+} // namespace
 
-    // Split binary into chunks and process concurrently
-    for (unsigned int i = 0; i < numThreads; ++i) {
-        size_t start = i * chunkSize;
-        size_t end = (i == numThreads - 1) ? paddedBinary.length() : start + chunkSize;
-        
-        threads.emplace_back([this, &paddedBinary, &results, i, start, end, mode]() {
-            std::string chunk = paddedBinary.substr(start, end - start);
-            results[i] = convertChunk(chunk, mode);
-        });
-    }
+ProcessorSimulator::ProcessorSimulator()
+    : pool(&ThreadPool::shared()) {}
 
-    // Wait for all threads to complete
-    for (auto& thread : threads) {
-        thread.join();
+ProcessorSimulator::ProcessorSimulator(ThreadPool& pool)
+    : pool(&pool) {}
+
+bool ProcessorSimulator::validateBinaryInput(std::string_view binaryStr) {
+    // Check if the input contains only 0s and 1s
+    return std::all_of(binaryStr.begin(), binaryStr.end(), [](char c) {
+        return c == '0' || c == '1';
+    });
+}
+
+size_t ProcessorSimulator::maxHexLength(size_t bitCount, ConversionMode mode) {
+    switch (mode) {
+        case ConversionMode::SIGNED:
+            return (bitCount + 31) / 32 * 8;
+        case ConversionMode::FLOATING_POINT:
+            return kFixedWidthOutputCapacity;
+        default:
+            return ConversionEngine::hexLength(bitCount);
     }
+}
 
-    // Combine results
-    std::stringstream finalResult;
-    for (const auto& result : results) {
-        finalResult << result;
+std::string ProcessorSimulator::binaryToHex(std::string_view binaryStr, ConversionMode mode) {
+    std::string hex(maxHexLength(binaryStr.length(), mode), '\0');
+    hex.resize(binaryToHex(binaryStr, mode, &hex[0], hex.size()));
+    return hex;
+}
+
+size_t ProcessorSimulator::binaryToHex(std::string_view binary, ConversionMode mode, char* out, size_t capacity) {
+    return convertInto(binary, mode, out, capacity, convertDigitsOrThrow);
+}
+
+std::string ProcessorSimulator::hexToBinary(std::string_view hexStr) {
+    std::string binary(hexStr.length() * 4, '\0');
+    hexToBinary(hexStr, &binary[0], binary.size());
+    return binary;
+}
+
+size_t ProcessorSimulator::hexToBinary(std::string_view hex, char* out, size_t capacity) {
+    size_t length = hex.length() * 4;
+    if (length <= capacity && !ConversionEngine::hexToBinary(hex.data(), hex.length(), out)) {
+        throw ProcessorSimulatorException("Invalid hex input: must contain only 0-9 and A-F");
     }
+    return length;
+}
 
-    return finalResult.str();
+std::string ProcessorSimulator::multiThreadedBinaryToHex(std::string_view binaryStr, ConversionMode mode) {
+    std::string hex(maxHexLength(binaryStr.length(), mode), '\0');
+    hex.resize(multiThreadedBinaryToHex(binaryStr, mode, &hex[0], hex.size()));
+    return hex;
 }
 
-std::string ProcessorSimulator::convertChunk(const std::string& chunk, ConversionMode mode) {
-    // This method is similar to binaryToHex, but works on smaller chunks
-    std::stringstream hexStream;
-    hexStream << std::hex << std::uppercase;
+size_t ProcessorSimulator::multiThreadedBinaryToHex(std::string_view binary, ConversionMode mode,
+                                                    char* out, size_t capacity) {
+    return convertInto(binary, mode, out, capacity, [this](std::string_view bits, char* digits) {
+        multiThreadedBinaryToHex(bits, digits);
+    });
+}
 
-    switch (mode) {
-        case ConversionMode::STANDARD:
-        case ConversionMode::UNSIGNED:
-            for (size_t i = 0; i < chunk.length(); i += 4) {
-                std::string subChunk = chunk.substr(i, 4);
-                unsigned long decimal = std::bitset<4>(subChunk).to_ulong();
-                hexStream << decimal;
-            }
-            break;
+void ProcessorSimulator::multiThreadedBinaryToHex(std::string_view binary, char* output) {
+    // The leading partial group is converted first so every chunk starts on a nibble boundary
+    size_t leading = binary.length() % 4;
+    size_t leadingDigits = leading != 0 ? 1 : 0;
+    const char* alignedBits = binary.data() + leading;
+    char* alignedHex = output + leadingDigits;
 
-        case ConversionMode::SIGNED: {
-            std::bitset<64> bits(chunk);
-            int64_t signedDecimal = static_cast<int64_t>(bits.to_ulong());
-            hexStream << std::hex << signedDecimal;
-            break;
-        }
+    std::atomic<bool> valid{ConversionEngine::binaryToHex(binary.data(), leading, output)};
+    pool->parallelFor(binary.length() / 4, kMinParallelBits / 4,
+        [&](size_t begin, size_t end) {
+            if (!ConversionEngine::convertAligned(alignedBits + begin * 4, end - begin, alignedHex + begin)) {
+                valid.store(false, std::memory_order_relaxed);
+            }
+        },
+        parallelism);
 
-        case ConversionMode::FLOATING_POINT:
-            std::bitset<32> bits(chunk);
-            float floatValue = *reinterpret_cast<float*>(&bits);
-            hexStream << std::hex << std::scientific << floatValue;
-            break;
+    if (!valid.load()) {
+        throwInvalidBinary();
     }
-
-    return hexStream.str();
 }
 
 void ProcessorSimulator::executeInstruction(const std::string& instruction) {
-    // Basic instruction simulation
-    // This is a placeholder for more complex processor instruction simulation
     if (instruction.empty()) {
         throw ProcessorSimulatorException("Empty instruction");
     }
-    // Future implementation would parse and execute different types of instructions
+
+    auto it = decodeCache.find(instruction);
+    if (it == decodeCache.end()) {
+        Instruction decoded = InstructionSet::assemble(instruction);
+        if (decodeCache.size() >= kDecodeCacheLimit) {
+            decodeCache.clear();
+        }
+        it = decodeCache.emplace(instruction, decoded).first;
+    }
+    Interpreter::step(state, memory, &program, it->second, &blocks);
+}
+
+void ProcessorSimulator::loadProgram(std::string_view source, uint64_t base) {
+    program = InstructionSet::assembleProgram(source, base);
+    uint64_t address = program.base;
+    for (const Instruction& instruction : program.code) {
+        memory.store64(address, instruction.encode());
+        address += InstructionSet::kInstructionBytes;
+    }
+    blocks.clear();
+    state.setPc(program.base);
+    state.setHalted(false);
+}
+
+uint64_t ProcessorSimulator::run(uint64_t maxSteps) {
+    // SYNC only separates the quanta of a multi-core simulation; a single core runs on
+    uint64_t steps = 0;
+    // Traced runs record every step, so they stay on the instruction-at-a-time tier
+    if (trace != nullptr) {
+        while (steps < maxSteps && !state.isHalted()) {
+            steps += Interpreter::run(state, memory, program, maxSteps - steps, *trace, &blocks);
+        }
+        return steps;
+    }
+    if (caches != nullptr) {
+        while (steps < maxSteps && !state.isHalted()) {
+            steps += Interpreter::run(state, memory, program, maxSteps - steps, *caches, &blocks);
+        }
+        return steps;
+    }
+    while (steps < maxSteps && !state.isHalted()) {
+        steps += Interpreter::run(state, memory, program, blocks, maxSteps - steps);
+    }
+    return steps;
+}
+
+SampledRun ProcessorSimulator::runSampled(CacheHierarchy& model, const SamplingPlan& plan, uint64_t maxSteps) {
+    if (plan.window == 0) {
+        throw ProcessorSimulatorException("Sampling window must not be empty");
+    }
+    CacheHierarchy* attached = caches;
+    bool counting = model.isCounting();
+    model.resetStats();
+    SampledRun result;
+
+    auto runFor = [&](uint64_t count, CacheHierarchy* target) {
+        caches = target;
+        uint64_t executed = run(std::min(count, maxSteps - result.instructions));
+        result.instructions += executed;
+        return executed;
+    };
+    try {
+        while (result.instructions < maxSteps && !state.isHalted()) {
+            runFor(plan.fastForward, nullptr);
+            model.setCounting(false);
+            runFor(plan.warmup, &model);
+            model.setCounting(true);
+            uint64_t measured = runFor(plan.window, &model);
+            if (measured > 0) {
+                result.detailedInstructions += measured;
+                ++result.windows;
+            }
+        }
+    } catch (...) {
+        caches = attached;
+        model.setCounting(counting);
+        throw;
+    }
+    caches = attached;
+    model.setCounting(counting);
+
+    const CacheHierarchy::Stats& stats = model.getStats();
+    result.cyclesPerInstruction = stats.cyclesPerInstruction();
+    result.estimatedCycles = static_cast<uint64_t>(result.cyclesPerInstruction *
+                                                   static_cast<double>(result.instructions));
+    return result;
+}
+
+Checkpoint ProcessorSimulator::checkpoint() const {
+    return Checkpoint{state, memory, program};
+}
+
+void ProcessorSimulator::restore(const Checkpoint& checkpoint) {
+    state = checkpoint.state;
+    memory = checkpoint.memory;
+    program = checkpoint.program;
+    blocks.clear();
 }
 
 void ProcessorSimulator::ProcessorState::reset() {
-    registers.clear();
+    registers.fill(0);
+    writtenMask = 0;
+    namedRegisters.clear();
+    pc = 0;
+    flags = 0;
+    halted = false;
 }
 
 void ProcessorSimulator::ProcessorState::setRegister(const std::string& name, uint64_t value) {
-    registers[name] = value;
+    int index = InstructionSet::registerIndex(name);
+    if (index >= 0) {
+        writeRegister(static_cast<size_t>(index), value);
+    } else {
+        namedRegisters[name] = value;
+    }
 }
 
 uint64_t ProcessorSimulator::ProcessorState::getRegister(const std::string& name) const {
-    auto it = registers.find(name);
-    if (it != registers.end()) {
-        return it->second;
+    int index = InstructionSet::registerIndex(name);
+    if (index >= 0 && (writtenMask & (1u << index)) != 0) {
+        return registers[static_cast<size_t>(index)];
+    }
+    if (index < 0) {
+        auto it = namedRegisters.find(name);
+        if (it != namedRegisters.end()) {
+            return it->second;
+        }
     }
     throw ProcessorSimulatorException("Register not found: " + name);
 }
@@ -1,7 +1,9 @@
 #ifndef PROCESSOR_SIMULATOR_HPP
 #define PROCESSOR_SIMULATOR_HPP
 
+#include <array>
 #include <string>
+#include <string_view>
 #include <bitset>
 #include <sstream>
 #include <iomanip>
@@ -12,6 +14,16 @@
 #include <algorithm>
 #include <limits>
 #include <unordered_map>
+#include "block_cache.hpp"
+#include "instruction_set.hpp"
+#include "simulated_memory.hpp"
+
+class ThreadPool;
+class TraceWriter;
+class CacheHierarchy;
+struct Checkpoint;
+struct SamplingPlan;
+struct SampledRun;
 
 // Enum for different conversion modes
 enum class ConversionMode {
@@ -23,15 +35,61 @@ enum class ConversionMode {
 
 class ProcessorSimulator {
 public:
-    // Processor state simulation
+    // Inputs shorter than this many bits are converted on the calling thread
+    static constexpr size_t kMinParallelBits = 256 * 1024;
+
+    // Uses the process-wide thread pool unless one is injected
+    ProcessorSimulator();
+    explicit ProcessorSimulator(ThreadPool& pool);
+
+    // Processor state simulation.
+    //
+    // The architectural registers R0-R15 live in a fixed array indexed by
+    // register number, next to the PC and flags, so the interpreter reaches
+    // them without hashing. The string API resolves the name on each call and
+    // is kept for compatibility; names other than R0-R15 go to a side table.
     class ProcessorState {
     public:
+        // Condition flags set by CMP/CMPI
+        static constexpr uint8_t kFlagZero = 1 << 0;
+        static constexpr uint8_t kFlagNegative = 1 << 1;  // Signed less than
+        static constexpr uint8_t kFlagCarry = 1 << 2;     // Unsigned less than
+
         void reset();
         void setRegister(const std::string& name, uint64_t value);
+
+        // Throws for a register that has not been written since the last reset
         uint64_t getRegister(const std::string& name) const;
-        
+
+        // Register by index (0-15); unwritten registers read as zero
+        uint64_t readRegister(size_t index) const { return registers[index]; }
+        void writeRegister(size_t index, uint64_t value) {
+            registers[index] = value;
+            writtenMask |= static_cast<uint16_t>(1u << index);
+        }
+
+        // Bit i is set once register i has been written
+        uint16_t getWrittenMask() const { return writtenMask; }
+
+        uint64_t getPc() const { return pc; }
+        void setPc(uint64_t value) { pc = value; }
+        uint8_t getFlags() const { return flags; }
+        void setFlags(uint8_t value) { flags = value; }
+        bool isHalted() const { return halted; }
+        void setHalted(bool value) { halted = value; }
+
+        // Registers outside R0-R15 that have been set by name
+        const std::unordered_map<std::string, uint64_t>& getNamedRegisters() const { return namedRegisters; }
+
     private:
-        std::unordered_map<std::string, uint64_t> registers;
+        std::array<uint64_t, InstructionSet::kRegisterCount> registers{};
+        uint64_t pc = 0;
+        uint16_t writtenMask = 0;
+        uint8_t flags = 0;
+        bool halted = false;
+
+        // Registers outside R0-R15, only reachable by name
+        std::unordered_map<std::string, uint64_t> namedRegisters;
     };
 
     // Public accessor for processor state
@@ -39,28 +97,99 @@ public:
     const ProcessorState& getState() const { return state; }
 
     // Enhanced binary to hex conversion with multiple modes
-    static std::string binaryToHex(const std::string& binaryStr, 
+    static std::string binaryToHex(std::string_view binaryStr, 
                                    ConversionMode mode = ConversionMode::STANDARD);
     
+    // Reverse conversion: every hex digit (either case) becomes four bits
+    static std::string hexToBinary(std::string_view hexStr);
+
     // Multi-threaded conversion with error handling
-    std::string multiThreadedBinaryToHex(const std::string& binaryStr, 
+    std::string multiThreadedBinaryToHex(std::string_view binaryStr, 
                                          ConversionMode mode = ConversionMode::STANDARD);
+
+    // Allocation-free conversions into a caller buffer of `capacity` characters.
+    //
+    // Each returns the length of the result. If that exceeds `capacity`
+    // nothing is written (and the input is not necessarily validated), so a
+    // caller can retry with a larger buffer; size it with maxHexLength() to
+    // convert in one call. Invalid input throws ProcessorSimulatorException.
+    static size_t binaryToHex(std::string_view binary, ConversionMode mode, char* out, size_t capacity);
+    static size_t hexToBinary(std::string_view hex, char* out, size_t capacity);
+    size_t multiThreadedBinaryToHex(std::string_view binary, ConversionMode mode, char* out, size_t capacity);
+
+    // Upper bound of the binaryToHex output length for `bitCount` input bits
+    static size_t maxHexLength(size_t bitCount, ConversionMode mode);
+
+    // Multi-threaded digit-wise conversion straight into a caller buffer of
+    // ConversionEngine::hexLength(binary.size()) characters
+    void multiThreadedBinaryToHex(std::string_view binary, char* output);
+
+    // Maximum threads used by multiThreadedBinaryToHex (0 = whole pool)
+    void setParallelism(unsigned threads) { parallelism = threads; }
+    unsigned getParallelism() const { return parallelism; }
     
-    // Instruction execution simulation
+    // Instruction execution simulation: executes one instruction at the
+    // current PC. Each distinct instruction text is assembled only once.
     void executeInstruction(const std::string& instruction);
+
+    // Assembles `source` (see instruction_set.hpp), writes it to memory at
+    // `base` and points the PC at its first instruction
+    void loadProgram(std::string_view source, uint64_t base = 0);
+
+    // Runs the loaded program until HALT or `maxSteps` instructions; returns the number executed
+    uint64_t run(uint64_t maxSteps = std::numeric_limits<uint64_t>::max());
+
+    SimulatedMemory& getMemory() { return memory; }
+    const SimulatedMemory& getMemory() const { return memory; }
+
+    // Record the steps executed by run() into `writer` (nullptr stops recording)
+    void setTrace(TraceWriter* writer) { trace = writer; }
+
+    // Feed the loads and stores of run() into `model` (nullptr detaches it).
+    // Runs with a cache model attached are not block-translated, and a
+    // recording trace takes precedence over the model.
+    void setCacheModel(CacheHierarchy* model) { caches = model; }
+
+    // Runs like run(), estimating the cycles of the whole run from detailed
+    // windows through `model` separated by functional fast-forward; see
+    // cache_hierarchy.hpp. The statistics of `model` cover the windows only.
+    SampledRun runSampled(CacheHierarchy& model, const SamplingPlan& plan,
+                          uint64_t maxSteps = std::numeric_limits<uint64_t>::max());
+
+    // Captures the registers, memory and loaded program. Memory pages are
+    // shared copy-on-write with the simulator, so the cost does not depend
+    // on how much memory is in use; see checkpoint.hpp.
+    Checkpoint checkpoint() const;
+
+    // Returns to `checkpoint`, which stays valid and can be restored again
+    void restore(const Checkpoint& checkpoint);
     
     // Validate binary input
-    static bool validateBinaryInput(const std::string& binaryStr);
+    static bool validateBinaryInput(std::string_view binaryStr);
 
 private:
-    // Thread-safe conversion helper
-    std::string convertChunk(const std::string& chunk, ConversionMode mode);
-    
+    // Worker pool used for parallel conversions
+    ThreadPool* pool;
+    unsigned parallelism = 0;
+    TraceWriter* trace = nullptr;
+    CacheHierarchy* caches = nullptr;
+
     // Mutex for thread-safe operations
     std::mutex conversionMutex;
     
     // Processor state
     ProcessorState state;
+    SimulatedMemory memory;
+
+    // Decoded copy of the loaded program
+    Program program;
+
+    // Translated hot blocks of `program`; see interpreter.hpp
+    BlockCache blocks;
+
+    // Assembled form of instructions passed to executeInstruction, by text
+    static constexpr size_t kDecodeCacheLimit = 4096;
+    std::unordered_map<std::string, Instruction> decodeCache;
 };
 
 // Custom exception for processor simulator
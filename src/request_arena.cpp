@@ -0,0 +1,71 @@
+#include "request_arena.hpp"
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+struct ThreadBlock {
+    std::unique_ptr<std::byte[]> data;
+    size_t size = 0;
+    bool inUse = false;
+};
+
+ThreadBlock& threadBlock() {
+    thread_local ThreadBlock block;
+    if (!block.data) {
+        block.data = std::make_unique<std::byte[]>(RequestArena::kInitialBytes);
+        block.size = RequestArena::kInitialBytes;
+    }
+    return block;
+}
+
+// Claims the thread's block unless an enclosing scope already holds it
+bool claimBlock() {
+    ThreadBlock& block = threadBlock();
+    if (block.inUse) {
+        return false;
+    }
+    block.inUse = true;
+    return true;
+}
+
+} // namespace
+
+RequestArena::Scope::Scope()
+    : reusesBlock(claimBlock()),
+      monotonic(reusesBlock ? threadBlock().data.get() : nullptr,
+                reusesBlock ? threadBlock().size : 0,
+                &overflow) {}
+
+RequestArena::Scope::~Scope() {
+    monotonic.release();
+    if (!reusesBlock) {
+        return;
+    }
+
+    ThreadBlock& block = threadBlock();
+    block.inUse = false;
+    if (overflow.bytes > 0 && block.size < kMaxRetainedBytes) {
+        size_t grown = std::min(kMaxRetainedBytes, std::max(block.size * 2, block.size + overflow.bytes));
+        block.data = std::make_unique<std::byte[]>(grown);
+        block.size = grown;
+    }
+}
+
+void* RequestArena::Scope::Overflow::do_allocate(size_t size, size_t alignment) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void RequestArena::Scope::Overflow::do_deallocate(void* p, size_t size, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+bool RequestArena::Scope::Overflow::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+size_t RequestArena::retainedBytes() {
+    return threadBlock().size;
+}
@@ -0,0 +1,53 @@
+#ifndef REQUEST_ARENA_HPP
+#define REQUEST_ARENA_HPP
+
+#include <cstddef>
+#include <memory_resource>
+
+// Per-thread scratch memory for the transient allocations of one request.
+//
+// Each thread keeps one block. While a Scope is open, a monotonic resource
+// hands out memory from that block without freeing anything, and the whole
+// block is rewound when the Scope closes. What does not fit comes from the
+// global allocator; the block then grows to cover it (up to
+// kMaxRetainedBytes), so the next request of that size stays in the block.
+//
+// Memory from a Scope must only be used on the thread that opened it and must
+// not outlive it.
+class RequestArena {
+public:
+    static constexpr size_t kInitialBytes = 64 * 1024;
+    static constexpr size_t kMaxRetainedBytes = 4 * 1024 * 1024;
+
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        std::pmr::memory_resource* resource() { return &monotonic; }
+
+    private:
+        // Upstream of the monotonic resource that counts what overflowed the block
+        class Overflow : public std::pmr::memory_resource {
+        public:
+            size_t bytes = 0;
+
+        private:
+            void* do_allocate(size_t size, size_t alignment) override;
+            void do_deallocate(void* p, size_t size, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+        };
+
+        bool reusesBlock;  // False for a scope nested in another on this thread
+        Overflow overflow;
+        std::pmr::monotonic_buffer_resource monotonic;
+    };
+
+    // Size of the calling thread's block
+    static size_t retainedBytes();
+};
+
+#endif // REQUEST_ARENA_HPP
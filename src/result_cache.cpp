@@ -0,0 +1,94 @@
+#include "result_cache.hpp"
+
+#include <functional>
+
+namespace {
+
+// Approximate bookkeeping cost of one entry: list node, map node and string headers
+constexpr size_t kEntryOverheadBytes = 160;
+
+} // namespace
+
+ConversionResultCache::ConversionResultCache(size_t memoryBudgetBytes)
+    : shardBudget(memoryBudgetBytes / kShardCount) {}
+
+size_t ConversionResultCache::hashKey(ConversionMode mode, std::string_view input) {
+    size_t hash = std::hash<std::string_view>()(input);
+    return hash ^ (static_cast<size_t>(mode) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2));
+}
+
+ConversionResultCache::Result ConversionResultCache::find(ConversionMode mode, std::string_view input) {
+    if (shardBudget == 0) {
+        return nullptr;
+    }
+
+    size_t hash = hashKey(mode, input);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(Key{hash, mode, input});
+    if (it == shard.index.end()) {
+        missCount.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    hitCount.fetch_add(1, std::memory_order_relaxed);
+    return it->second->result;
+}
+
+bool ConversionResultCache::mayCache(size_t inputBytes) const {
+    return inputBytes + kEntryOverheadBytes <= shardBudget / 4;
+}
+
+void ConversionResultCache::insert(ConversionMode mode, std::string_view input, Result result) {
+    size_t bytes = input.size() + result->size() + kEntryOverheadBytes;
+    // Large values would evict a whole shard's worth of hot entries
+    if (bytes > shardBudget / 4) {
+        return;
+    }
+
+    size_t hash = hashKey(mode, input);
+    Shard& shard = shardFor(hash);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.index.count(Key{hash, mode, input}) != 0) {
+        return;  // Another thread got there first
+    }
+
+    shard.lru.push_front(Entry{mode, hash, std::string(input), std::move(result), bytes});
+    Entry& entry = shard.lru.front();
+    shard.index.emplace(Key{hash, mode, entry.input}, shard.lru.begin());
+    shard.bytes += bytes;
+
+    while (shard.bytes > shardBudget) {
+        Entry& victim = shard.lru.back();
+        shard.index.erase(Key{victim.hash, victim.mode, victim.input});
+        shard.bytes -= victim.bytes;
+        shard.lru.pop_back();
+    }
+}
+
+ConversionResultCache::Result ConversionResultCache::convert(ConversionMode mode, std::string_view input) {
+    if (Result cached = find(mode, input)) {
+        return cached;
+    }
+    auto result = std::make_shared<const std::string>(ProcessorSimulator::binaryToHex(input, mode));
+    insert(mode, input, result);
+    return result;
+}
+
+size_t ConversionResultCache::memoryUsage() const {
+    size_t total = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.bytes;
+    }
+    return total;
+}
+
+size_t ConversionResultCache::entryCount() const {
+    size_t total = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.lru.size();
+    }
+    return total;
+}
@@ -0,0 +1,93 @@
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "processor_simulator.hpp"
+
+// Bounded, sharded LRU cache of conversion results keyed on (mode, input).
+//
+// Keys are hashed once and routed to one of kShardCount independently
+// locked shards. Results are shared immutable strings, so a hit hands out
+// the cached string without converting or copying it again. Each shard
+// evicts least-recently-used entries to stay within its share of the
+// memory budget; inputs too large to be worth caching are never stored.
+class ConversionResultCache {
+public:
+    using Result = std::shared_ptr<const std::string>;
+
+    static constexpr size_t kShardCount = 16;
+
+    // memoryBudgetBytes == 0 disables the cache
+    explicit ConversionResultCache(size_t memoryBudgetBytes);
+
+    ConversionResultCache(const ConversionResultCache&) = delete;
+    ConversionResultCache& operator=(const ConversionResultCache&) = delete;
+
+    // Returns nullptr on a miss
+    Result find(ConversionMode mode, std::string_view input);
+
+    void insert(ConversionMode mode, std::string_view input, Result result);
+
+    // False for inputs whose entry could never be stored; callers convert
+    // those directly instead of going through convert()
+    bool mayCache(size_t inputBytes) const;
+
+    // Cached result, or binaryToHex() stored for next time; throws like binaryToHex
+    Result convert(ConversionMode mode, std::string_view input);
+
+    uint64_t hits() const { return hitCount.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return missCount.load(std::memory_order_relaxed); }
+    size_t memoryUsage() const;
+    size_t entryCount() const;
+    size_t memoryBudget() const { return shardBudget * kShardCount; }
+
+private:
+    // Map key that refers to the input owned by its list entry
+    struct Key {
+        size_t hash;
+        ConversionMode mode;
+        std::string_view input;
+
+        bool operator==(const Key& other) const {
+            return mode == other.mode && input == other.input;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const { return key.hash; }
+    };
+
+    struct Entry {
+        ConversionMode mode;
+        size_t hash;
+        std::string input;
+        Result result;
+        size_t bytes;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;  // Most recently used first
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        size_t bytes = 0;
+    };
+
+    static size_t hashKey(ConversionMode mode, std::string_view input);
+    Shard& shardFor(size_t hash) { return shards[(hash >> 7) % kShardCount]; }
+
+    std::array<Shard, kShardCount> shards;
+    size_t shardBudget;
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+};
+
+#endif // RESULT_CACHE_HPP
@@ -0,0 +1,183 @@
+#include "server_metrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const char* const kKindLabels[] = {"STANDARD", "SIGNED", "UNSIGNED", "FLOATING_POINT", "batch", "unknown"};
+const char* const kOutcomeLabels[] = {"ok", "invalid_input", "bad_request"};
+
+template <size_t N>
+size_t bucketIndex(const std::array<uint64_t, N>& bounds, uint64_t value) {
+    return static_cast<size_t>(std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin());
+}
+
+void appendNumber(std::string& out, double value) {
+    char digits[32];
+    std::snprintf(digits, sizeof(digits), "%.9g", value);
+    out += digits;
+}
+
+// Emits the _bucket/_sum/_count series of one labelled histogram
+template <size_t N>
+void appendHistogram(std::string& out, const char* name, const char* kind,
+                     const std::array<uint64_t, N>& bounds, const uint64_t* buckets,
+                     uint64_t sum, double scale) {
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= N; ++i) {
+        cumulative += buckets[i];
+        out += name;
+        out += "_bucket{mode=\"";
+        out += kind;
+        out += "\",le=\"";
+        if (i < N) {
+            appendNumber(out, static_cast<double>(bounds[i]) * scale);
+        } else {
+            out += "+Inf";
+        }
+        out += "\"} ";
+        out += std::to_string(cumulative);
+        out += '\n';
+    }
+    out += name;
+    out += "_sum{mode=\"";
+    out += kind;
+    out += "\"} ";
+    appendNumber(out, static_cast<double>(sum) * scale);
+    out += '\n';
+    out += name;
+    out += "_count{mode=\"";
+    out += kind;
+    out += "\"} ";
+    out += std::to_string(cumulative);
+    out += '\n';
+}
+
+} // namespace
+
+ServerMetrics::Shard& ServerMetrics::localShard() {
+    // Threads are spread over the shards in the order they first record something
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    return shards[shard];
+}
+
+void ServerMetrics::recordConversion(RequestKind kind, Outcome outcome, size_t inputBits) {
+    Shard& shard = localShard();
+    size_t k = static_cast<size_t>(kind);
+    shard.conversions[k][static_cast<size_t>(outcome)].fetch_add(1, std::memory_order_relaxed);
+    shard.sizeBuckets[k][bucketIndex(kSizeBucketsBits, inputBits)].fetch_add(1, std::memory_order_relaxed);
+    shard.sizeSum[k].fetch_add(inputBits, std::memory_order_relaxed);
+}
+
+void ServerMetrics::recordLatency(RequestKind kind, std::chrono::steady_clock::duration latency) {
+    Shard& shard = localShard();
+    size_t k = static_cast<size_t>(kind);
+    auto micros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    shard.latencyBuckets[k][bucketIndex(kLatencyBucketsMicros, micros)].fetch_add(1, std::memory_order_relaxed);
+    shard.latencySumMicros[k].fetch_add(micros, std::memory_order_relaxed);
+}
+
+void ServerMetrics::requestStarted() {
+    localShard().inFlight.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ServerMetrics::requestFinished() {
+    localShard().inFlight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::string ServerMetrics::renderPrometheus(const Gauges& gauges) const {
+    // Sum the shards first so each series is read once
+    uint64_t conversions[kKindCount][kOutcomeCount] = {};
+    uint64_t sizeBuckets[kKindCount][kSizeBucketCount] = {};
+    uint64_t sizeSum[kKindCount] = {};
+    uint64_t latencyBuckets[kKindCount][kLatencyBucketCount] = {};
+    uint64_t latencySum[kKindCount] = {};
+    int64_t inFlight = 0;
+
+    for (const Shard& shard : shards) {
+        for (size_t k = 0; k < kKindCount; ++k) {
+            for (size_t o = 0; o < kOutcomeCount; ++o) {
+                conversions[k][o] += shard.conversions[k][o].load(std::memory_order_relaxed);
+            }
+            for (size_t b = 0; b < kSizeBucketCount; ++b) {
+                sizeBuckets[k][b] += shard.sizeBuckets[k][b].load(std::memory_order_relaxed);
+            }
+            for (size_t b = 0; b < kLatencyBucketCount; ++b) {
+                latencyBuckets[k][b] += shard.latencyBuckets[k][b].load(std::memory_order_relaxed);
+            }
+            sizeSum[k] += shard.sizeSum[k].load(std::memory_order_relaxed);
+            latencySum[k] += shard.latencySumMicros[k].load(std::memory_order_relaxed);
+        }
+        inFlight += shard.inFlight.load(std::memory_order_relaxed);
+    }
+
+    std::string out;
+    out.reserve(16 * 1024);
+
+    out += "# HELP processor_conversions_total Converted values by mode and outcome.\n";
+    out += "# TYPE processor_conversions_total counter\n";
+    for (size_t k = 0; k < kKindCount; ++k) {
+        if (static_cast<RequestKind>(k) == RequestKind::BATCH) {
+            continue;  // Batch items are counted under their own mode
+        }
+        for (size_t o = 0; o < kOutcomeCount; ++o) {
+            out += "processor_conversions_total{mode=\"";
+            out += kKindLabels[k];
+            out += "\",outcome=\"";
+            out += kOutcomeLabels[o];
+            out += "\"} ";
+            out += std::to_string(conversions[k][o]);
+            out += '\n';
+        }
+    }
+
+    out += "# HELP processor_conversion_input_bits Size of converted inputs in bits.\n";
+    out += "# TYPE processor_conversion_input_bits histogram\n";
+    for (size_t k = 0; k < kKindCount; ++k) {
+        if (static_cast<RequestKind>(k) == RequestKind::BATCH) {
+            continue;
+        }
+        appendHistogram(out, "processor_conversion_input_bits", kKindLabels[k], kSizeBucketsBits,
+                        sizeBuckets[k], sizeSum[k], 1.0);
+    }
+
+    out += "# HELP processor_request_duration_seconds Request handling latency by mode.\n";
+    out += "# TYPE processor_request_duration_seconds histogram\n";
+    for (size_t k = 0; k < kKindCount; ++k) {
+        appendHistogram(out, "processor_request_duration_seconds", kKindLabels[k], kLatencyBucketsMicros,
+                        latencyBuckets[k], latencySum[k], 1e-6);
+    }
+
+    out += "# HELP processor_in_flight_requests Requests currently being handled.\n";
+    out += "# TYPE processor_in_flight_requests gauge\n";
+    out += "processor_in_flight_requests " + std::to_string(std::max<int64_t>(inFlight, 0)) + "\n";
+
+    out += "# HELP processor_thread_pool_queue_depth Tasks waiting in the conversion thread pool.\n";
+    out += "# TYPE processor_thread_pool_queue_depth gauge\n";
+    out += "processor_thread_pool_queue_depth " + std::to_string(gauges.threadPoolQueueDepth) + "\n";
+
+    out += "# HELP processor_thread_pool_threads Worker threads in the conversion thread pool.\n";
+    out += "# TYPE processor_thread_pool_threads gauge\n";
+    out += "processor_thread_pool_threads " + std::to_string(gauges.threadPoolThreads) + "\n";
+
+    out += "# HELP processor_cache_hits_total Conversions served from the result cache.\n";
+    out += "# TYPE processor_cache_hits_total counter\n";
+    out += "processor_cache_hits_total " + std::to_string(gauges.cacheHits) + "\n";
+
+    out += "# HELP processor_cache_misses_total Result cache lookups that had to convert.\n";
+    out += "# TYPE processor_cache_misses_total counter\n";
+    out += "processor_cache_misses_total " + std::to_string(gauges.cacheMisses) + "\n";
+
+    out += "# HELP processor_cache_bytes Approximate memory held by the result cache.\n";
+    out += "# TYPE processor_cache_bytes gauge\n";
+    out += "processor_cache_bytes " + std::to_string(gauges.cacheBytes) + "\n";
+
+    out += "# HELP processor_cache_entries Entries in the result cache.\n";
+    out += "# TYPE processor_cache_entries gauge\n";
+    out += "processor_cache_entries " + std::to_string(gauges.cacheEntries) + "\n";
+
+    return out;
+}
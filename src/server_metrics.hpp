@@ -0,0 +1,99 @@
+#ifndef SERVER_METRICS_HPP
+#define SERVER_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "processor_simulator.hpp"
+
+// Request instrumentation for the HTTP server, rendered in the Prometheus
+// text exposition format.
+//
+// Every counter lives in one of several cache-line-aligned shards; a thread
+// always updates the same shard with relaxed atomics, so recording never
+// contends with other threads. Rendering sums the shards.
+class ServerMetrics {
+public:
+    // Label values for the "mode" label beyond the four conversion modes
+    enum class RequestKind {
+        STANDARD,
+        SIGNED,
+        UNSIGNED,
+        FLOATING_POINT,
+        BATCH,
+        UNKNOWN
+    };
+
+    enum class Outcome {
+        OK,
+        INVALID_INPUT,
+        BAD_REQUEST
+    };
+
+    static constexpr size_t kShardCount = 16;
+    static constexpr size_t kKindCount = 6;
+    static constexpr size_t kOutcomeCount = 3;
+
+    // Upper bounds of the histogram buckets (+Inf is implicit)
+    static constexpr std::array<uint64_t, 12> kSizeBucketsBits = {
+        4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, 4194304, 16777216};
+    static constexpr std::array<uint64_t, 12> kLatencyBucketsMicros = {
+        10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 100000, 1000000};
+
+    static RequestKind kindOf(ConversionMode mode) { return static_cast<RequestKind>(mode); }
+
+    // One converted value: counts by mode and outcome plus the input size histogram
+    void recordConversion(RequestKind kind, Outcome outcome, size_t inputBits);
+
+    // One HTTP request: latency histogram by mode
+    void recordLatency(RequestKind kind, std::chrono::steady_clock::duration latency);
+
+    void requestStarted();
+    void requestFinished();
+
+    // Keeps the in-flight gauge raised for the lifetime of a handler
+    class InFlight {
+    public:
+        explicit InFlight(ServerMetrics& metrics) : metrics(metrics) { metrics.requestStarted(); }
+        ~InFlight() { metrics.requestFinished(); }
+        InFlight(const InFlight&) = delete;
+        InFlight& operator=(const InFlight&) = delete;
+
+    private:
+        ServerMetrics& metrics;
+    };
+
+    // Values owned by other components, sampled at scrape time
+    struct Gauges {
+        size_t threadPoolQueueDepth = 0;
+        size_t threadPoolThreads = 0;
+        uint64_t cacheHits = 0;
+        uint64_t cacheMisses = 0;
+        size_t cacheBytes = 0;
+        size_t cacheEntries = 0;
+    };
+
+    std::string renderPrometheus(const Gauges& gauges) const;
+
+private:
+    static constexpr size_t kSizeBucketCount = kSizeBucketsBits.size() + 1;
+    static constexpr size_t kLatencyBucketCount = kLatencyBucketsMicros.size() + 1;
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> conversions[kKindCount][kOutcomeCount] = {};
+        std::atomic<uint64_t> sizeBuckets[kKindCount][kSizeBucketCount] = {};
+        std::atomic<uint64_t> sizeSum[kKindCount] = {};
+        std::atomic<uint64_t> latencyBuckets[kKindCount][kLatencyBucketCount] = {};
+        std::atomic<uint64_t> latencySumMicros[kKindCount] = {};
+        std::atomic<int64_t> inFlight{0};
+    };
+
+    Shard& localShard();
+
+    std::array<Shard, kShardCount> shards;
+};
+
+#endif // SERVER_METRICS_HPP
@@ -0,0 +1,152 @@
+#include "simulated_memory.hpp"
+#include "processor_simulator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+void checkAligned(uint64_t address) {
+    if (address % sizeof(uint64_t) != 0) {
+        std::ostringstream message;
+        message << "Misaligned memory access at 0x" << std::hex << address;
+        throw ProcessorSimulatorException(message.str());
+    }
+}
+
+// Makes `shared` the only owner of its object, copying it if anyone else
+// holds it. A use_count() of 1 means the last other owner has let go; the
+// fence orders its earlier reads before our writes.
+template <typename T>
+T& unshare(std::shared_ptr<T>& shared) {
+    if (!shared) {
+        shared = std::make_shared<T>();
+    } else if (shared.use_count() > 1) {
+        shared = std::make_shared<T>(*shared);
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *shared;
+}
+
+} // namespace
+
+const SimulatedMemory::Page* SimulatedMemory::findPage(uint64_t address) const {
+    if (directories) {
+        uint64_t number = address / kPageBytes;
+        auto it = directories->find(number / kDirectoryPages);
+        if (it != directories->end()) {
+            if (const Page* page = it->second->pages[number % kDirectoryPages].get()) {
+                return page;
+            }
+        }
+    }
+    return backing != nullptr ? backing->findPage(address) : nullptr;
+}
+
+std::shared_ptr<SimulatedMemory::Page>& SimulatedMemory::ownSlot(uint64_t pageNumber) {
+    Directory& directory = unshare(unshare(directories)[pageNumber / kDirectoryPages]);
+    return directory.pages[pageNumber % kDirectoryPages];
+}
+
+SimulatedMemory::Page& SimulatedMemory::pageFor(uint64_t address) {
+    std::shared_ptr<Page>& page = ownSlot(address / kPageBytes);
+    if (!page) {
+        page = std::make_shared<Page>();
+        const Page* below = backing != nullptr ? backing->findPage(address) : nullptr;
+        if (below != nullptr) {
+            page->words = below->words;
+        } else {
+            page->words.fill(0);
+        }
+        page->written.fill(0);
+        ++ownedPages;
+        return *page;
+    }
+    return unshare(page);
+}
+
+void SimulatedMemory::loadPage(uint64_t number, const uint64_t* words, const uint64_t* written) {
+    auto page = std::make_shared<Page>();
+    std::memcpy(page->words.data(), words, kPageBytes);
+    std::memcpy(page->written.data(), written, sizeof(page->written));
+    std::shared_ptr<Page>& slot = ownSlot(number);
+    if (!slot) {
+        ++ownedPages;
+    }
+    slot = std::move(page);
+}
+
+void SimulatedMemory::markWritten(Page& page, size_t firstWord, size_t lastWord) {
+    for (size_t word = firstWord; word <= lastWord; ++word) {
+        page.written[word / 64] |= uint64_t{1} << (word % 64);
+    }
+}
+
+uint64_t SimulatedMemory::load64(uint64_t address) const {
+    checkAligned(address);
+    const Page* page = findPage(address);
+    return page != nullptr ? page->words[address % kPageBytes / sizeof(uint64_t)] : 0;
+}
+
+void SimulatedMemory::store64(uint64_t address, uint64_t value) {
+    checkAligned(address);
+    Page& page = pageFor(address);
+    size_t word = address % kPageBytes / sizeof(uint64_t);
+    page.words[word] = value;
+    page.written[word / 64] |= uint64_t{1} << (word % 64);
+}
+
+void SimulatedMemory::read(uint64_t address, void* out, size_t size) const {
+    auto* bytes = static_cast<unsigned char*>(out);
+    while (size > 0) {
+        size_t offset = static_cast<size_t>(address % kPageBytes);
+        size_t count = std::min<size_t>(size, kPageBytes - offset);
+        if (const Page* page = findPage(address)) {
+            std::memcpy(bytes, reinterpret_cast<const unsigned char*>(page->words.data()) + offset, count);
+        } else {
+            std::memset(bytes, 0, count);
+        }
+        bytes += count;
+        address += count;
+        size -= count;
+    }
+}
+
+void SimulatedMemory::write(uint64_t address, const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    while (size > 0) {
+        size_t offset = static_cast<size_t>(address % kPageBytes);
+        size_t count = std::min<size_t>(size, kPageBytes - offset);
+        Page& page = pageFor(address);
+        std::memcpy(reinterpret_cast<unsigned char*>(page.words.data()) + offset, bytes, count);
+        markWritten(page, offset / sizeof(uint64_t), (offset + count - 1) / sizeof(uint64_t));
+        bytes += count;
+        address += count;
+        size -= count;
+    }
+}
+
+void SimulatedMemory::commitTo(SimulatedMemory& target) {
+    forEachPage([&](uint64_t number, const uint64_t* words, const uint64_t* written) {
+        Page* destination = nullptr;
+        for (size_t group = 0; group < kWrittenWords; ++group) {
+            uint64_t bits = written[group];
+            if (bits == 0) {
+                continue;
+            }
+            if (destination == nullptr) {
+                destination = &target.pageFor(number * kPageBytes);
+            }
+            for (size_t bit = 0; bit < 64; ++bit) {
+                if ((bits >> bit & 1) != 0) {
+                    destination->words[group * 64 + bit] = words[group * 64 + bit];
+                }
+            }
+            destination->written[group] |= bits;
+        }
+    });
+    clear();
+}
@@ -0,0 +1,98 @@
+#ifndef SIMULATED_MEMORY_HPP
+#define SIMULATED_MEMORY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+// Sparse, byte-addressed memory of the simulated machine.
+//
+// The 64-bit address space is split into 4 KiB pages that are allocated on
+// first write; reads from untouched memory return zero. Words are stored in
+// host byte order.
+//
+// A memory constructed over a `backing` memory is an overlay: pages it has
+// not written read through to the backing memory, and the first write to a
+// page copies it. Written words are tracked, so commitTo() publishes exactly
+// those words. The backing memory must not change while overlays read it.
+//
+// Copies are copy-on-write: copying a memory takes O(1) and shares its pages
+// until one side writes. Pages are grouped into directories of
+// kDirectoryPages, so a write copies the small top-level table once, then a
+// directory and a page the first time it touches them. Copies may be written
+// on different threads.
+class SimulatedMemory {
+public:
+    static constexpr uint64_t kPageBytes = 4096;
+    static constexpr size_t kPageWords = kPageBytes / sizeof(uint64_t);
+    static constexpr size_t kWrittenWords = kPageWords / 64;  // Bitmap of written words
+    static constexpr size_t kDirectoryPages = 512;
+
+    SimulatedMemory() = default;
+    explicit SimulatedMemory(const SimulatedMemory* backing)
+        : backing(backing) {}
+
+    // 8-byte accesses; the address must be 8-byte aligned
+    uint64_t load64(uint64_t address) const;
+    void store64(uint64_t address, uint64_t value);
+
+    // Unaligned byte copies, which may span pages
+    void read(uint64_t address, void* out, size_t size) const;
+    void write(uint64_t address, const void* data, size_t size);
+
+    // Copies every word written since the last commit (or clear) into
+    // `target`, then drops this memory's own pages. Partially written words
+    // are copied whole.
+    void commitTo(SimulatedMemory& target);
+
+    // Pages owned by this memory, not counting the backing memory
+    size_t pageCount() const { return ownedPages; }
+    void clear() {
+        directories.reset();
+        ownedPages = 0;
+    }
+
+    // Calls visit(pageNumber, words, written) for each page this memory
+    // owns, where `words` holds kPageWords words and `written` kWrittenWords
+    template <typename Visit>
+    void forEachPage(Visit visit) const {
+        if (directories) {
+            for (const auto& [directory, entries] : *directories) {
+                for (size_t i = 0; i < kDirectoryPages; ++i) {
+                    if (const Page* page = entries->pages[i].get()) {
+                        visit(directory * kDirectoryPages + i, page->words.data(), page->written.data());
+                    }
+                }
+            }
+        }
+    }
+
+    // Replaces page `number` with a copy of `words` and `written`
+    void loadPage(uint64_t number, const uint64_t* words, const uint64_t* written);
+
+private:
+    struct Page {
+        std::array<uint64_t, kPageWords> words;
+        std::array<uint64_t, kWrittenWords> written;  // One bit per word
+    };
+
+    struct Directory {
+        std::array<std::shared_ptr<Page>, kDirectoryPages> pages;
+    };
+
+    // Directories by page number / kDirectoryPages
+    using PageTable = std::unordered_map<uint64_t, std::shared_ptr<Directory>>;
+
+    const Page* findPage(uint64_t address) const;
+    Page& pageFor(uint64_t address);
+    std::shared_ptr<Page>& ownSlot(uint64_t pageNumber);
+    static void markWritten(Page& page, size_t firstWord, size_t lastWord);
+
+    const SimulatedMemory* backing = nullptr;
+    std::shared_ptr<PageTable> directories;  // Null while empty; shared with copies
+    size_t ownedPages = 0;
+};
+
+#endif // SIMULATED_MEMORY_HPP
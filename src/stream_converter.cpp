@@ -0,0 +1,170 @@
+#include "stream_converter.hpp"
+#include "conversion_engine.hpp"
+#include "processor_simulator.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+} // namespace
+
+StreamingHexConverter::StreamingHexConverter(Sink sink, size_t blockSize)
+    : sink(std::move(sink)), block(std::max<size_t>(blockSize, 1), '\0') {}
+
+StreamingHexConverter::StreamingHexConverter(std::ostream& out, size_t blockSize)
+    : StreamingHexConverter([&out](const char* data, size_t length) {
+          out.write(data, static_cast<std::streamsize>(length));
+      }, blockSize) {}
+
+void StreamingHexConverter::setTotalBits(uint64_t bits) {
+    if (consumed != 0 || finished) {
+        throw ProcessorSimulatorException("Total length must be declared before streaming starts");
+    }
+    totalDeclared = true;
+    totalBits = bits;
+    leadingBits = static_cast<size_t>(bits % 4);
+}
+
+void StreamingHexConverter::push(std::string_view bits) {
+    if (finished) {
+        throw ProcessorSimulatorException("Stream already finished");
+    }
+    if (!ignoreWhitespace) {
+        pushBits(bits.data(), bits.size());
+        return;
+    }
+
+    const char* cursor = bits.data();
+    const char* end = cursor + bits.size();
+    while (cursor != end) {
+        const char* runEnd = std::find_if(cursor, end, isWhitespace);
+        pushBits(cursor, static_cast<size_t>(runEnd - cursor));
+        cursor = std::find_if_not(runEnd, end, isWhitespace);
+    }
+}
+
+void StreamingHexConverter::finish() {
+    if (finished) {
+        return;
+    }
+    if (totalDeclared && consumed != totalBits) {
+        throw ProcessorSimulatorException("Stream ended after " + std::to_string(consumed) +
+                                          " of " + std::to_string(totalBits) + " declared bits");
+    }
+    if (carryUsed > 0) {
+        emitCarry();
+    }
+    flush();
+    finished = true;
+}
+
+void StreamingHexConverter::pushBits(const char* bits, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    consumed += count;
+
+    // Complete the declared leading group, then any nibble left over from the last push
+    if (leadingBits > 0) {
+        fillCarry(bits, count, leadingBits);
+        if (carryUsed < leadingBits) {
+            return;
+        }
+        emitCarry();
+        leadingBits = 0;
+    }
+    if (carryUsed > 0) {
+        fillCarry(bits, count, 4);
+        if (carryUsed < 4) {
+            return;
+        }
+        emitCarry();
+    }
+
+    // Whole nibbles are converted straight into the output block
+    size_t nibbles = count / 4;
+    while (nibbles > 0) {
+        size_t batch = std::min(nibbles, block.size() - blockUsed);
+        if (!ConversionEngine::convertAligned(bits, batch, &block[blockUsed])) {
+            throwInvalid();
+        }
+        blockUsed += batch;
+        written += batch;
+        bits += batch * 4;
+        count -= batch * 4;
+        nibbles -= batch;
+        if (blockUsed == block.size()) {
+            flush();
+        }
+    }
+
+    std::memcpy(carry, bits, count);
+    carryUsed = count;
+}
+
+void StreamingHexConverter::fillCarry(const char*& bits, size_t& count, size_t groupSize) {
+    size_t take = std::min(count, groupSize - carryUsed);
+    std::memcpy(carry + carryUsed, bits, take);
+    carryUsed += take;
+    bits += take;
+    count -= take;
+}
+
+void StreamingHexConverter::emitCarry() {
+    if (!ConversionEngine::binaryToHex(carry, carryUsed, &block[blockUsed])) {
+        throwInvalid();
+    }
+    carryUsed = 0;
+    ++blockUsed;
+    ++written;
+    if (blockUsed == block.size()) {
+        flush();
+    }
+}
+
+void StreamingHexConverter::flush() {
+    if (blockUsed > 0) {
+        sink(block.data(), blockUsed);
+        blockUsed = 0;
+    }
+}
+
+void StreamingHexConverter::throwInvalid() {
+    finished = true;
+    throw ProcessorSimulatorException("Invalid binary input: must contain only 0s and 1s");
+}
+
+StreamOutcome convertStream(StreamingHexConverter& converter, const BodyReader& read, uint64_t maxBits) {
+    StreamOutcome outcome;
+    bool complete = read([&](const char* data, size_t length) {
+        if (converter.bitsConsumed() + length > maxBits) {
+            outcome.tooLarge = true;
+            outcome.error = "Stream exceeds " + std::to_string(maxBits) + " bits";
+            return false;
+        }
+        try {
+            converter.push(std::string_view(data, length));
+            return true;
+        } catch (const ProcessorSimulatorException& e) {
+            outcome.error = e.what();
+            return false;
+        }
+    });
+    // Without a declared total, finish() cannot tell a cut-off body from a short one
+    if (outcome.error.empty() && !complete) {
+        outcome.error = "Request body ended early";
+    }
+    if (outcome.error.empty()) {
+        try {
+            converter.finish();
+        } catch (const ProcessorSimulatorException& e) {
+            outcome.error = e.what();
+        }
+    }
+    return outcome;
+}
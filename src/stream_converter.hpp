@@ -0,0 +1,86 @@
+#ifndef STREAM_CONVERTER_HPP
+#define STREAM_CONVERTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Incremental binary-text to hex-text converter for unbounded inputs.
+//
+// Bits are pushed in arbitrary pieces; a partial nibble is carried over to
+// the next push. Hex digits are collected in a fixed-size block and handed
+// to the sink whenever the block fills up, so memory use does not depend
+// on the input length.
+//
+// When the total length is declared with setTotalBits() the output matches
+// ProcessorSimulator::binaryToHex exactly (the first digit absorbs the
+// partial leading group). Otherwise digits are grouped from the start of
+// the stream and a trailing partial group becomes a final digit of its own.
+class StreamingHexConverter {
+public:
+    using Sink = std::function<void(const char* data, size_t length)>;
+
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit StreamingHexConverter(Sink sink, size_t blockSize = kDefaultBlockSize);
+    explicit StreamingHexConverter(std::ostream& out, size_t blockSize = kDefaultBlockSize);
+
+    // Must be called before the first push
+    void setTotalBits(uint64_t totalBits);
+
+    // Skip spaces, tabs and line breaks instead of rejecting them
+    void setIgnoreWhitespace(bool ignore) { ignoreWhitespace = ignore; }
+
+    // Throws ProcessorSimulatorException on invalid input or after finish()
+    void push(std::string_view bits);
+
+    // Emit the final partial digit and flush the remaining output
+    void finish();
+
+    uint64_t bitsConsumed() const { return consumed; }
+    uint64_t digitsWritten() const { return written; }
+
+private:
+    void pushBits(const char* bits, size_t count);
+    void fillCarry(const char*& bits, size_t& count, size_t groupSize);
+    void emitCarry();
+    void flush();
+    [[noreturn]] void throwInvalid();
+
+    Sink sink;
+    std::string block;
+    size_t blockUsed = 0;
+
+    // Bits of an incomplete nibble carried between pushes
+    char carry[4] = {};
+    size_t carryUsed = 0;
+    size_t leadingBits = 0;
+
+    bool totalDeclared = false;
+    uint64_t totalBits = 0;
+    uint64_t consumed = 0;
+    uint64_t written = 0;
+    bool ignoreWhitespace = false;
+    bool finished = false;
+};
+
+// A body that arrives in pieces, such as an httplib ContentReader: calls
+// the receiver for each piece until it returns false, and returns false if
+// the body ended before it was complete
+using BodyReceiver = std::function<bool(const char* data, size_t length)>;
+using BodyReader = std::function<bool(const BodyReceiver& receiver)>;
+
+struct StreamOutcome {
+    std::string error;      // Empty if the whole body was converted
+    bool tooLarge = false;  // The body had more than the allowed bits
+};
+
+// Pushes a body into `converter` as it is read and finishes the stream.
+// Stops at the first invalid piece, past `maxBits` bits, or if the body
+// ends early; a sink that throws ProcessorSimulatorException stops it too.
+StreamOutcome convertStream(StreamingHexConverter& converter, const BodyReader& read, uint64_t maxBits);
+
+#endif // STREAM_CONVERTER_HPP
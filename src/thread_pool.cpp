@@ -0,0 +1,198 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+// Identifies the pool worker running on the current thread, if any
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local unsigned currentWorker = 0;
+
+// Shared between the caller of parallelFor and its helper tasks. Helpers
+// that start after the caller has drained every range do nothing.
+struct ParallelJob {
+    const std::function<void(size_t, size_t)>* body = nullptr;
+    size_t count = 0;
+    size_t rangeSize = 0;
+    size_t rangeCount = 0;
+    std::atomic<size_t> nextRange{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    unsigned active = 0;
+    bool closed = false;
+
+    void runRanges() {
+        size_t range;
+        while ((range = nextRange.fetch_add(1, std::memory_order_relaxed)) < rangeCount) {
+            if (failed.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            size_t begin = range * rangeSize;
+            size_t end = std::min(count, begin + rangeSize);
+            try {
+                (*body)(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 4;  // Default to 4 threads if detection fails
+    }
+
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Workers push to their own deque; everyone else spreads tasks round-robin
+    unsigned index = currentPool == this
+        ? currentWorker
+        : nextWorker.fetch_add(1, std::memory_order_relaxed) % threadCount();
+
+    pendingTasks.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain,
+                             const std::function<void(size_t, size_t)>& body,
+                             unsigned maxParallelism) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+
+    unsigned parallelism = maxParallelism == 0 ? threadCount() + 1 : maxParallelism;
+    size_t maxRanges = (count + grain - 1) / grain;
+    size_t helpers = std::min<size_t>(parallelism - 1, maxRanges - 1);
+    if (helpers == 0) {
+        // Below the grain (or parallelism 1): run inline
+        body(0, count);
+        return;
+    }
+
+    // Over-partition so faster threads pick up the slack
+    auto job = std::make_shared<ParallelJob>();
+    size_t ranges = std::min(maxRanges, (helpers + 1) * 4);
+    job->body = &body;
+    job->count = count;
+    job->rangeSize = (count + ranges - 1) / ranges;
+    job->rangeCount = (count + job->rangeSize - 1) / job->rangeSize;
+
+    for (size_t i = 0; i < helpers; ++i) {
+        submit([job]() {
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                if (job->closed) {
+                    return;
+                }
+                ++job->active;
+            }
+            job->runRanges();
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (--job->active == 0) {
+                job->finished.notify_all();
+            }
+        });
+    }
+
+    job->runRanges();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->closed = true;
+    job->finished.wait(lock, [&job]() { return job->active == 0; });
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    currentPool = this;
+    currentWorker = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (popTask(index, task) || stealTask(index, task)) {
+            pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() {
+            return stopping || pendingTasks.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping && pendingTasks.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::popTask(unsigned index, std::function<void()>& task) {
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::stealTask(unsigned thief, std::function<void()>& task) {
+    unsigned count = threadCount();
+    for (unsigned offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,69 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent work-stealing thread pool.
+//
+// Each worker owns a deque: it pops its own tasks LIFO and steals from the
+// front of other workers' deques when it runs dry. Tasks submitted from
+// outside the pool are distributed round-robin across the workers.
+class ThreadPool {
+public:
+    // threadCount == 0 uses the hardware concurrency
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool sized to the hardware concurrency
+    static ThreadPool& shared();
+
+    unsigned threadCount() const { return static_cast<unsigned>(workers.size()); }
+
+    // Tasks submitted but not yet picked up by a worker
+    size_t queueDepth() const { return pendingTasks.load(std::memory_order_relaxed); }
+
+    // Queue a task for asynchronous execution; tasks must not throw
+    void submit(std::function<void()> task);
+
+    // Run body(begin, end) over [0, count) in ranges of at least `grain`
+    // items, using at most `maxParallelism` threads including the caller
+    // (0 = caller plus every worker). The calling thread takes part in the
+    // work, so this may be used from inside pool tasks. The first exception
+    // thrown by `body` is rethrown once all ranges have finished.
+    void parallelFor(size_t count, size_t grain,
+                     const std::function<void(size_t, size_t)>& body,
+                     unsigned maxParallelism = 0);
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(unsigned index);
+    bool popTask(unsigned index, std::function<void()>& task);
+    bool stealTask(unsigned thief, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // Sleeping workers wait here until pendingTasks becomes non-zero
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<size_t> pendingTasks{0};
+    std::atomic<unsigned> nextWorker{0};
+    bool stopping = false;
+};
+
+#endif // THREAD_POOL_HPP
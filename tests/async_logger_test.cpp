@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "../src/async_logger.hpp"
+
+namespace {
+
+size_t countLines(const std::string& text) {
+    return static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+}
+
+} // namespace
+
+TEST(AsyncLoggerTest, WritesStructuredLines) {
+    std::ostringstream out;
+    {
+        AsyncLogger logger(out);
+        logger.log(LogLevel::INFO, "request", {{"path", "/convert"}, {"status", 200}, {"duration_us", -5LL},
+                                               {"ratio", 0.5}, {"body", "{\"binary\": \"1\"}"}});
+        logger.flush();
+    }
+    std::string line = out.str();
+    EXPECT_EQ(line.rfind("ts=", 0), 0u);
+    EXPECT_NE(line.find(" level=info event=request path=/convert status=200 duration_us=-5 ratio=0.5 "
+                        "body=\"{\\\"binary\\\": \\\"1\\\"}\"\n"),
+              std::string::npos) << line;
+}
+
+TEST(AsyncLoggerTest, FiltersByLevel) {
+    std::ostringstream out;
+    AsyncLogger logger(out, LogLevel::WARNING);
+    EXPECT_FALSE(logger.enabled(LogLevel::INFO));
+    logger.log(LogLevel::DEBUG, "hidden");
+    logger.log(LogLevel::INFO, "hidden");
+    logger.log(LogLevel::ERROR, "shown");
+    logger.flush();
+    EXPECT_EQ(countLines(out.str()), 1u);
+    EXPECT_NE(out.str().find("level=error event=shown"), std::string::npos);
+
+    logger.setLevel(LogLevel::OFF);
+    EXPECT_FALSE(logger.enabled(LogLevel::ERROR));
+}
+
+TEST(AsyncLoggerTest, TruncatesLongLines) {
+    std::ostringstream out;
+    AsyncLogger logger(out);
+    std::string huge(4 * AsyncLogger::kMaxLineBytes, 'x');
+    logger.log(LogLevel::INFO, "big", {{"body", huge}});
+    logger.flush();
+    std::string line = out.str();
+    EXPECT_LT(line.size(), 2 * AsyncLogger::kMaxLineBytes);
+    EXPECT_NE(line.find("...\n"), std::string::npos);
+}
+
+TEST(AsyncLoggerTest, AcceptsConcurrentProducers) {
+    std::ostringstream out;
+    uint64_t dropped;
+    {
+        AsyncLogger logger(out, LogLevel::INFO, 256);
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; ++t) {
+            producers.emplace_back([&logger, t]() {
+                for (int i = 0; i < 2000; ++i) {
+                    logger.log(LogLevel::INFO, "tick", {{"thread", t}, {"i", i}});
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        logger.flush();
+        dropped = logger.droppedCount();
+    }
+    EXPECT_EQ(countLines(out.str()) + dropped, 8000u);
+}
+
+TEST(AsyncLoggerTest, ParsesLevelNames) {
+    EXPECT_EQ(parseLogLevel("debug"), LogLevel::DEBUG);
+    EXPECT_EQ(parseLogLevel("off"), LogLevel::OFF);
+    EXPECT_EQ(parseLogLevel("verbose", LogLevel::ERROR), LogLevel::ERROR);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
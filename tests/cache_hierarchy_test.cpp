@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "../src/cache_hierarchy.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+// One level of 2 sets x 2 ways of 64-byte lines
+CacheHierarchy tinyCache() {
+    return CacheHierarchy({{"L1", 256, 2, 64, 1}}, 10);
+}
+
+// Sums 4096 consecutive words from 0x10000, R7 times over
+const char* const kStreamProgram =
+    "    LI R6, 0\n"
+    "pass:\n"
+    "    LI R1, 0x10000\n"
+    "    LI R5, 4096\n"
+    "loop:\n"
+    "    LOAD R2, 0(R1)\n"
+    "    ADD R3, R3, R2\n"
+    "    STORE R3, 0(R1)\n"
+    "    ADDI R1, R1, 8\n"
+    "    ADDI R5, R5, -1\n"
+    "    CMPI R5, 0\n"
+    "    BNE loop\n"
+    "    ADDI R6, R6, 1\n"
+    "    CMP R6, R7\n"
+    "    BNE pass\n"
+    "    HALT\n";
+
+} // namespace
+
+TEST(CacheHierarchyTest, LatencyAddsUpThroughTheLevels) {
+    CacheHierarchy caches;
+    EXPECT_EQ(caches.access(0x1000, false), 4u + 14u + 42u + CacheHierarchy::kDefaultDramLatency);
+    EXPECT_EQ(caches.access(0x1008, false), 4u);
+
+    const CacheHierarchy::Stats& stats = caches.getStats();
+    EXPECT_EQ(stats.loads, 2u);
+    EXPECT_EQ(stats.dramAccesses, 1u);
+    EXPECT_EQ(stats.levels[0].hits, 1u);
+    EXPECT_EQ(stats.levels[0].misses, 1u);
+    EXPECT_EQ(stats.levels[2].misses, 1u);
+    EXPECT_DOUBLE_EQ(stats.levels[0].hitRate(), 0.5);
+}
+
+TEST(CacheHierarchyTest, EvictsTheLeastRecentlyUsedWay) {
+    CacheHierarchy caches = tinyCache();
+    caches.access(0 * 64, false);    // Set 0
+    caches.access(2 * 64, false);    // Set 0
+    caches.access(0 * 64, false);    // Line 2 is now the older
+    caches.access(4 * 64, false);    // Evicts line 2
+    EXPECT_EQ(caches.access(0 * 64, false), 1u);
+    EXPECT_EQ(caches.access(2 * 64, false), 11u);
+    EXPECT_EQ(caches.access(1 * 64, false), 11u);  // Set 1 is untouched
+}
+
+TEST(CacheHierarchyTest, CountsWritebacksOfStoredLines) {
+    CacheHierarchy caches = tinyCache();
+    caches.access(0, true);
+    caches.access(2 * 64, false);
+    caches.access(4 * 64, false);  // Evicts the stored line
+    caches.access(6 * 64, false);  // Evicts a clean one
+    EXPECT_EQ(caches.getStats().levels[0].writebacks, 1u);
+    EXPECT_EQ(caches.getStats().stores, 1u);
+}
+
+TEST(CacheHierarchyTest, WarmUpIsNotCounted) {
+    CacheHierarchy caches = tinyCache();
+    caches.setCounting(false);
+    caches.access(0, false);
+    caches.retire(10);
+    caches.setCounting(true);
+    EXPECT_EQ(caches.access(0, false), 1u);
+    EXPECT_EQ(caches.getStats().levels[0].misses, 0u);
+    EXPECT_EQ(caches.getStats().instructions, 0u);
+
+    caches.invalidate();
+    EXPECT_EQ(caches.access(0, false), 11u);
+}
+
+TEST(CacheHierarchyTest, ParsesAndValidatesLevels) {
+    std::vector<CacheLevelConfig> levels = CacheHierarchy::parseLevels("L1:32K:8:64:4,L2:2M:16:128:12");
+    ASSERT_EQ(levels.size(), 2u);
+    EXPECT_EQ(levels[0].name, "L1");
+    EXPECT_EQ(levels[0].sizeBytes, 32u * 1024);
+    EXPECT_EQ(levels[1].sizeBytes, 2u * 1024 * 1024);
+    EXPECT_EQ(levels[1].lineBytes, 128u);
+    EXPECT_EQ(levels[1].latencyCycles, 12u);
+    EXPECT_NO_THROW(CacheHierarchy{levels});
+
+    EXPECT_THROW(CacheHierarchy::parseLevels("L1:32K:8:64"), ProcessorSimulatorException);
+    EXPECT_THROW(CacheHierarchy::parseLevels("L1:32X:8:64:4"), ProcessorSimulatorException);
+    EXPECT_THROW(CacheHierarchy({{"L1", 3000, 8, 64, 4}}), ProcessorSimulatorException);
+    EXPECT_THROW(CacheHierarchy({{"L1", 32768, 8, 48, 4}}), ProcessorSimulatorException);
+    EXPECT_THROW(CacheHierarchy({{"L1", 32768, 0, 64, 4}}), ProcessorSimulatorException);
+}
+
+TEST(CacheHierarchyTest, SimulatorFeedsLoadsAndStores) {
+    CacheHierarchy caches;
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kStreamProgram);
+    simulator.getState().writeRegister(7, 20);
+    simulator.setCacheModel(&caches);
+    uint64_t steps = simulator.run();
+    simulator.setCacheModel(nullptr);
+
+    const CacheHierarchy::Stats& stats = caches.getStats();
+    EXPECT_EQ(stats.instructions, steps);
+    EXPECT_EQ(stats.loads, 20u * 4096);
+    EXPECT_EQ(stats.stores, 20u * 4096);
+    // 32 KiB of data: only the first pass misses in L1, once per 8 words
+    EXPECT_EQ(stats.levels[0].misses, 4096u / 8);
+    EXPECT_EQ(stats.dramAccesses, 4096u / 8);
+    EXPECT_GT(stats.cyclesPerInstruction(), 1.0);
+}
+
+TEST(CacheHierarchyTest, SamplingEstimatesTheDetailedRun) {
+    CacheHierarchy detailed;
+    ProcessorSimulator reference;
+    reference.loadProgram(kStreamProgram);
+    reference.getState().writeRegister(7, 100);
+    reference.setCacheModel(&detailed);
+    uint64_t steps = reference.run();
+
+    CacheHierarchy sampled;
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kStreamProgram);
+    simulator.getState().writeRegister(7, 100);
+    // The warm-up covers a whole pass over the data
+    SamplingPlan plan;
+    plan.fastForward = 200000;
+    plan.warmup = 30000;
+    plan.window = 10000;
+    SampledRun run = simulator.runSampled(sampled, plan);
+
+    EXPECT_EQ(run.instructions, steps);
+    EXPECT_TRUE(simulator.getState().isHalted());
+    EXPECT_EQ(simulator.getState().readRegister(3), reference.getState().readRegister(3));
+    EXPECT_GT(run.windows, 5u);
+    EXPECT_LT(run.detailedInstructions, steps / 5);
+    EXPECT_NEAR(static_cast<double>(run.estimatedCycles), static_cast<double>(detailed.getStats().cycles),
+                0.05 * static_cast<double>(detailed.getStats().cycles));
+
+    SamplingPlan empty;
+    empty.window = 0;
+    EXPECT_THROW(simulator.runSampled(sampled, empty), ProcessorSimulatorException);
+}
+
+TEST(CacheHierarchyTest, SamplingSeesSelfModifyingCode) {
+    // After 300 iterations the loop rewrites its "ADDI R1, R1, 1" into
+    // "ADDI R1, R1, 100", from the instruction word at 0x800
+    const char* source =
+        "    LI R4, 0x800\n"
+        "    LOAD R2, 0(R4)\n"
+        "loop:\n"
+        "    ADDI R5, R5, 1\n"
+        "patched:\n"
+        "    ADDI R1, R1, 1\n"
+        "    CMPI R5, 300\n"
+        "    BNE next\n"
+        "    LI R3, 24\n"
+        "    STORE R2, 0(R3)\n"
+        "next:\n"
+        "    CMPI R5, 600\n"
+        "    BLT loop\n"
+        "    HALT\n";
+    uint64_t replacement = InstructionSet::assemble("ADDI R1, R1, 100").encode();
+
+    // Whichever tier executes the patch, later fast-forwards must run the new code
+    for (uint64_t fastForward = 1; fastForward <= 64; fastForward += 3) {
+        CacheHierarchy caches;
+        ProcessorSimulator simulator;
+        simulator.loadProgram(source);
+        simulator.getMemory().store64(0x800, replacement);
+        SamplingPlan plan;
+        plan.fastForward = fastForward;
+        plan.warmup = 5;
+        plan.window = 5;
+        simulator.runSampled(caches, plan);
+        EXPECT_EQ(simulator.getState().readRegister(1), 300u + 300u * 100u) << "fast-forward " << fastForward;
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include "../src/checkpoint.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+// Adds a falling counter into one word of each of 200 consecutive pages,
+// so a checkpoint holds many pages and a fork copies only those it stores to
+const char* const kProgram =
+    "    LI R1, 0x1000\n"
+    "    LI R5, 200\n"
+    "loop:\n"
+    "    LOAD R2, 0(R1)\n"
+    "    ADD R2, R2, R5\n"
+    "    STORE R2, 0(R1)\n"
+    "    ADDI R1, R1, 4104\n"
+    "    ADDI R5, R5, -1\n"
+    "    CMPI R5, 0\n"
+    "    BNE loop\n"
+    "    HALT\n";
+
+constexpr uint64_t kStride = SimulatedMemory::kPageBytes + 8;
+
+// Named registers are not touched by the program, only carried along
+void setNamedRegisters(ProcessorSimulator& simulator) {
+    simulator.getState().setRegister("ACC", 77);
+    simulator.getState().setRegister("SP", 0xFF00);
+}
+
+void expectSameRun(ProcessorSimulator& actual, ProcessorSimulator& expected) {
+    EXPECT_EQ(actual.run(), expected.run());
+    EXPECT_EQ(actual.getState().getPc(), expected.getState().getPc());
+    EXPECT_EQ(actual.getState().getFlags(), expected.getState().getFlags());
+    EXPECT_TRUE(actual.getState().isHalted());
+    for (size_t r = 0; r < InstructionSet::kRegisterCount; ++r) {
+        EXPECT_EQ(actual.getState().readRegister(r), expected.getState().readRegister(r)) << "R" << r;
+    }
+    EXPECT_EQ(actual.getState().getNamedRegisters(), expected.getState().getNamedRegisters());
+    for (uint64_t address = 0x1000; address < 0x1000 + 200 * kStride; address += kStride) {
+        EXPECT_EQ(actual.getMemory().load64(address), expected.getMemory().load64(address));
+    }
+}
+
+} // namespace
+
+TEST(CheckpointTest, RestoreRewindsRegistersAndMemory) {
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kProgram);
+    setNamedRegisters(simulator);
+    simulator.run(1000);
+    Checkpoint checkpoint = simulator.checkpoint();
+    uint64_t word = simulator.getMemory().load64(0x1000);
+    uint64_t pc = simulator.getState().getPc();
+    size_t pages = simulator.getMemory().pageCount();
+
+    simulator.run();
+    simulator.getMemory().store64(0x1000, 0);
+    simulator.getState().setRegister("ACC", 1);
+    ASSERT_TRUE(simulator.getState().isHalted());
+    ASSERT_GT(simulator.getMemory().pageCount(), pages);
+
+    simulator.restore(checkpoint);
+    EXPECT_EQ(simulator.getState().getPc(), pc);
+    EXPECT_FALSE(simulator.getState().isHalted());
+    EXPECT_EQ(simulator.getMemory().load64(0x1000), word);
+    EXPECT_EQ(simulator.getState().getRegister("ACC"), 77u);
+
+    // The checkpoint itself was not disturbed by the run
+    EXPECT_EQ(checkpoint.memory.load64(0x1000), word);
+    EXPECT_EQ(checkpoint.memory.pageCount(), pages);
+    ProcessorSimulator reference;
+    reference.loadProgram(kProgram);
+    setNamedRegisters(reference);
+    reference.run(1000);
+    expectSameRun(simulator, reference);
+}
+
+TEST(CheckpointTest, ForksShareUntouchedPages) {
+    SimulatedMemory memory;
+    for (uint64_t page = 0; page < 64; ++page) {
+        memory.store64(page * SimulatedMemory::kPageBytes, page);
+    }
+
+    SimulatedMemory fork = memory;
+    fork.store64(8, 99);
+    memory.store64(16, 7);
+    EXPECT_EQ(fork.load64(8), 99u);
+    EXPECT_EQ(memory.load64(8), 0u);
+    EXPECT_EQ(fork.load64(16), 0u);
+    EXPECT_EQ(memory.load64(16), 7u);
+    for (uint64_t page = 0; page < 64; ++page) {
+        EXPECT_EQ(fork.load64(page * SimulatedMemory::kPageBytes), page);
+    }
+    EXPECT_EQ(fork.pageCount(), 64u);
+}
+
+TEST(CheckpointTest, ManyForksFromOnePrefix) {
+    ProcessorSimulator prefix;
+    prefix.loadProgram(kProgram);
+    prefix.run(500);
+    Checkpoint checkpoint = prefix.checkpoint();
+
+    // Each fork perturbs R5 differently; none may see another's stores
+    ProcessorSimulator simulator;
+    for (uint64_t fork = 1; fork <= 8; ++fork) {
+        simulator.restore(checkpoint);
+        simulator.getState().writeRegister(5, fork);
+        simulator.run();
+        EXPECT_EQ(simulator.getState().readRegister(5), 0u);
+        EXPECT_EQ(prefix.getMemory().load64(simulator.getState().readRegister(1) - kStride), 0u);
+    }
+    EXPECT_EQ(checkpoint.memory.load64(0x1000), prefix.getMemory().load64(0x1000));
+}
+
+TEST(CheckpointTest, SavesAndLoads) {
+    std::string path = ::testing::TempDir() + "checkpoint_roundtrip.bin";
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kProgram);
+    simulator.run(1234);
+    setNamedRegisters(simulator);
+    simulator.checkpoint().save(path);
+
+    Checkpoint loaded = Checkpoint::load(path);
+    EXPECT_EQ(loaded.state.getRegister("ACC"), 77u);
+    EXPECT_EQ(loaded.state.getRegister("SP"), 0xFF00u);
+    EXPECT_EQ(loaded.state.getWrittenMask(), simulator.getState().getWrittenMask());
+    EXPECT_EQ(loaded.memory.pageCount(), simulator.getMemory().pageCount());
+    ASSERT_EQ(loaded.program.code.size(), 10u);
+
+    ProcessorSimulator resumed;
+    resumed.restore(loaded);
+    expectSameRun(resumed, simulator);
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointTest, RejectsDamagedFiles) {
+    std::string path = ::testing::TempDir() + "checkpoint_damaged.bin";
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kProgram);
+    simulator.run(100);
+    simulator.checkpoint().save(path);
+
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    std::ofstream(path, std::ios::binary) << bytes.substr(0, bytes.size() - 1);
+    EXPECT_THROW(Checkpoint::load(path), ProcessorSimulatorException);
+
+    std::string newer = bytes;
+    newer[8] = 2;
+    std::ofstream(path, std::ios::binary) << newer;
+    EXPECT_THROW(Checkpoint::load(path), ProcessorSimulatorException);
+
+    std::ofstream(path, std::ios::binary) << "0101010101010101";
+    EXPECT_THROW(Checkpoint::load(path), ProcessorSimulatorException);
+    std::remove(path.c_str());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
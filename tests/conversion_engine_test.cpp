@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "../src/conversion_engine.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+// Straightforward nibble-by-nibble reference conversion
+std::string referenceHex(const std::string& binary) {
+    std::string padded = std::string((4 - binary.length() % 4) % 4, '0') + binary;
+    std::string hex;
+    for (size_t i = 0; i < padded.length(); i += 4) {
+        int value = std::stoi(padded.substr(i, 4), nullptr, 2);
+        hex += "0123456789ABCDEF"[value];
+    }
+    return hex;
+}
+
+std::string randomBinary(std::mt19937& rng, size_t length) {
+    std::string binary(length, '0');
+    for (char& c : binary) {
+        c = (rng() & 1) ? '1' : '0';
+    }
+    return binary;
+}
+
+std::string convert(const std::string& binary) {
+    std::string hex(ConversionEngine::hexLength(binary.length()), '\0');
+    EXPECT_TRUE(ConversionEngine::binaryToHex(binary.data(), binary.length(), &hex[0]));
+    return hex;
+}
+
+} // namespace
+
+class ConversionEngineTest : public ::testing::TestWithParam<ConversionEngine::Isa> {
+protected:
+    void SetUp() override {
+        previousIsa = ConversionEngine::activeIsa();
+        if (static_cast<int>(GetParam()) > static_cast<int>(ConversionEngine::detectIsa())) {
+            GTEST_SKIP() << ConversionEngine::isaName(GetParam()) << " not supported on this CPU";
+        }
+        ConversionEngine::setActiveIsa(GetParam());
+    }
+
+    void TearDown() override {
+        ConversionEngine::setActiveIsa(previousIsa);
+    }
+
+    ConversionEngine::Isa previousIsa = ConversionEngine::Isa::SCALAR;
+};
+
+TEST_P(ConversionEngineTest, MatchesReferenceForAllLengths) {
+    std::mt19937 rng(42);
+    for (size_t length = 0; length <= 300; ++length) {
+        std::string binary = randomBinary(rng, length);
+        EXPECT_EQ(convert(binary), referenceHex(binary)) << "length " << length;
+    }
+}
+
+TEST_P(ConversionEngineTest, MatchesLegacyExamples) {
+    EXPECT_EQ(convert("1010"), "A");
+    EXPECT_EQ(convert("00001010"), "0A");
+    EXPECT_EQ(convert("11110000"), "F0");
+    EXPECT_EQ(convert("101"), "5");
+    EXPECT_EQ(convert(""), "");
+}
+
+TEST_P(ConversionEngineTest, RejectsInvalidCharacterAtAnyPosition) {
+    std::mt19937 rng(7);
+    for (size_t length : {1u, 5u, 16u, 33u, 70u}) {
+        for (size_t pos = 0; pos < length; ++pos) {
+            for (char bad : {'2', '/', ' ', '\0', 'a', static_cast<char>(0xB0)}) {
+                std::string binary = randomBinary(rng, length);
+                binary[pos] = bad;
+                std::string hex(ConversionEngine::hexLength(length), '\0');
+                EXPECT_FALSE(ConversionEngine::binaryToHex(binary.data(), length, &hex[0]))
+                    << "length " << length << " position " << pos;
+            }
+        }
+    }
+}
+
+TEST_P(ConversionEngineTest, SimulatorUsesEngineForDigitModes) {
+    std::mt19937 rng(3);
+    std::string binary = randomBinary(rng, 4099);
+    EXPECT_EQ(ProcessorSimulator::binaryToHex(binary), referenceHex(binary));
+    EXPECT_EQ(ProcessorSimulator::binaryToHex(binary, ConversionMode::UNSIGNED), referenceHex(binary));
+}
+
+TEST_P(ConversionEngineTest, HexToBinaryRoundTrips) {
+    std::mt19937 rng(7);
+    for (size_t digits = 0; digits <= 80; ++digits) {
+        std::string binary = randomBinary(rng, digits * 4);
+        std::string hex = referenceHex(binary);
+        std::string back(binary.size(), '\0');
+        ASSERT_TRUE(ConversionEngine::hexToBinary(hex.data(), hex.size(), &back[0]));
+        EXPECT_EQ(back, binary) << "digits " << digits;
+    }
+
+    const std::string mixedCase = "0123456789abcdefABCDEF";
+    std::string bits(mixedCase.size() * 4, '\0');
+    ASSERT_TRUE(ConversionEngine::hexToBinary(mixedCase.data(), mixedCase.size(), &bits[0]));
+    EXPECT_EQ(bits.substr(40, 24), "101010111100110111101111");
+    EXPECT_EQ(bits.substr(64), "101010111100110111101111");
+}
+
+TEST_P(ConversionEngineTest, HexToBinaryRejectsInvalidCharacterAtAnyPosition) {
+    const char invalid[] = {'g', 'G', ':', '@', '`', ' ', '\0', static_cast<char>(0xC1)};
+    for (size_t position = 0; position < 40; position += 3) {
+        for (char c : invalid) {
+            std::string hex(40, 'f');
+            hex[position] = c;
+            std::string bits(hex.size() * 4, '\0');
+            EXPECT_FALSE(ConversionEngine::hexToBinary(hex.data(), hex.size(), &bits[0]))
+                << "position " << position << " char " << static_cast<int>(c);
+        }
+    }
+    EXPECT_THROW(ProcessorSimulator::hexToBinary("12x"), ProcessorSimulatorException);
+    EXPECT_EQ(ProcessorSimulator::hexToBinary("0aF"), "000010101111");
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    AllKernels, ConversionEngineTest,
+    ::testing::Values(ConversionEngine::Isa::SCALAR, ConversionEngine::Isa::SSE2, ConversionEngine::Isa::AVX2),
+    [](const ::testing::TestParamInfo<ConversionEngine::Isa>& info) {
+        return std::string(ConversionEngine::isaName(info.param));
+    });
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "../src/checkpoint.hpp"
+#include "../src/execution_trace.hpp"
+#include "../src/processor_simulator.hpp"
+#include "../src/simulated_memory.hpp"
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return ::testing::TempDir() + name;
+}
+
+// Loops with loads, stores, compares and taken and untaken branches
+const char* const kProgram =
+    "    LI R1, 0x1000\n"
+    "    LI R5, 37\n"
+    "loop:\n"
+    "    LOAD R2, 0(R1)\n"
+    "    ADD R2, R2, R5\n"
+    "    STORE R2, 0(R1)\n"
+    "    ADDI R1, R1, 8\n"
+    "    ADDI R5, R5, -1\n"
+    "    CMPI R5, 0\n"
+    "    BNE loop\n"
+    "    HALT\n";
+
+void expectSameState(const ProcessorSimulator::ProcessorState& actual,
+                     const ProcessorSimulator::ProcessorState& expected) {
+    EXPECT_EQ(actual.getPc(), expected.getPc());
+    EXPECT_EQ(actual.getFlags(), expected.getFlags());
+    EXPECT_EQ(actual.isHalted(), expected.isHalted());
+    EXPECT_EQ(actual.getWrittenMask(), expected.getWrittenMask());
+    for (size_t r = 0; r < InstructionSet::kRegisterCount; ++r) {
+        EXPECT_EQ(actual.readRegister(r), expected.readRegister(r)) << "R" << r;
+    }
+}
+
+uint64_t recordProgram(const std::string& path, uint32_t snapshotInterval) {
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kProgram);
+    TraceWriter writer(path, snapshotInterval);
+    simulator.setTrace(&writer);
+    uint64_t steps = simulator.run();
+    writer.close();
+    return steps;
+}
+
+} // namespace
+
+TEST(ExecutionTraceTest, SeeksToEveryStep) {
+    std::string path = tempPath("trace_seek.bin");
+    uint64_t steps = recordProgram(path, 10);
+
+    TraceReader reader(path);
+    ASSERT_EQ(reader.stepCount(), steps);
+    EXPECT_EQ(reader.snapshotInterval(), 10u);
+
+    for (uint64_t step = 0; step <= steps; ++step) {
+        ProcessorSimulator expected;
+        expected.loadProgram(kProgram);
+        expected.run(step);
+        expectSameState(reader.stateAt(step), expected.getState());
+    }
+    EXPECT_THROW(reader.seek(steps + 1), ProcessorSimulatorException);
+    std::remove(path.c_str());
+}
+
+TEST(ExecutionTraceTest, CursorReportsEffects) {
+    std::string path = tempPath("trace_cursor.bin");
+    recordProgram(path, 4096);
+
+    TraceReader reader(path);
+    TraceReader::Cursor cursor = reader.seek(4);  // Before the first STORE
+    TraceStep step;
+    ASSERT_TRUE(cursor.next(step));
+    EXPECT_EQ(step.step, 5u);
+    EXPECT_EQ(step.pc, 0x20u);
+    EXPECT_EQ(step.effects, TraceFormat::kStore);
+    EXPECT_EQ(step.address, 0x1000u);
+    EXPECT_EQ(step.stored, 37u);
+
+    // Replaying to the end visits every remaining step once
+    uint64_t visited = 1;
+    while (cursor.next(step)) {
+        ++visited;
+    }
+    EXPECT_EQ(cursor.position(), reader.stepCount());
+    EXPECT_EQ(visited, reader.stepCount() - 4);
+    EXPECT_TRUE(cursor.state().isHalted());
+    std::remove(path.c_str());
+}
+
+TEST(ExecutionTraceTest, FollowsStateChangesBetweenRuns) {
+    for (uint32_t interval : {10u, 4096u}) {
+        std::string path = tempPath("trace_restore.bin");
+        ProcessorSimulator simulator;
+        simulator.loadProgram(kProgram);
+        TraceWriter writer(path, interval);
+        simulator.setTrace(&writer);
+
+        // Run, rewind to a checkpoint and run on, one step at a time
+        simulator.run(15);
+        Checkpoint checkpoint = simulator.checkpoint();
+        simulator.run(40);
+        simulator.restore(checkpoint);
+        std::vector<ProcessorSimulator::ProcessorState> expected{simulator.getState()};
+        for (int i = 0; i < 30; ++i) {
+            if (i == 12) {
+                simulator.getState().setRegister("R6", 123);
+                expected.back() = simulator.getState();
+            }
+            simulator.run(1);
+            expected.push_back(simulator.getState());
+        }
+        writer.close();
+
+        TraceReader reader(path);
+        ASSERT_EQ(reader.stepCount(), 15u + 40u + 30u);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            expectSameState(reader.stateAt(55 + i), expected[i]);
+        }
+
+        // A cursor decoding from the start picks up the same states
+        TraceReader::Cursor cursor = reader.seek(0);
+        TraceStep step;
+        while (cursor.position() < 55) {
+            ASSERT_TRUE(cursor.next(step));
+        }
+        for (size_t i = 1; i < expected.size(); ++i) {
+            ASSERT_TRUE(cursor.next(step));
+            expectSameState(cursor.state(), expected[i]);
+        }
+        std::remove(path.c_str());
+    }
+}
+
+TEST(ExecutionTraceTest, ReplaysMemory) {
+    std::string path = tempPath("trace_memory.bin");
+    ProcessorSimulator simulator;
+    simulator.loadProgram(kProgram);
+    {
+        TraceWriter writer(path, 16);
+        simulator.setTrace(&writer);
+        simulator.run();
+    }
+
+    TraceReader reader(path);
+    SimulatedMemory memory;
+    reader.replayMemory(reader.stepCount(), memory);
+    for (uint64_t address = 0x1000; address < 0x1000 + 37 * 8; address += 8) {
+        EXPECT_EQ(memory.load64(address), simulator.getMemory().load64(address));
+    }
+    std::remove(path.c_str());
+}
+
+TEST(ExecutionTraceTest, ReadsTraceWithoutIndex) {
+    std::string path = tempPath("trace_full.bin");
+    std::string truncatedPath = tempPath("trace_truncated.bin");
+    uint64_t steps = recordProgram(path, 8);
+
+    // Drop the index and footer plus part of the last record, as after a crash
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    TraceReader full(path);
+    size_t indexBytes = 1 + 8 + 8 + 16 * ((steps / 8) + 1) + TraceFormat::kFooterBytes;
+    std::ofstream(truncatedPath, std::ios::binary) << bytes.substr(0, bytes.size() - indexBytes - 1);
+
+    TraceReader truncated(truncatedPath);
+    EXPECT_EQ(truncated.stepCount(), steps - 1);
+    expectSameState(truncated.stateAt(steps - 1), full.stateAt(steps - 1));
+    std::remove(path.c_str());
+    std::remove(truncatedPath.c_str());
+}
+
+TEST(ExecutionTraceTest, RejectsOtherFiles) {
+    std::string path = tempPath("not_a_trace.bin");
+    std::ofstream(path, std::ios::binary) << "0101010101010101010101";
+    EXPECT_THROW(TraceReader reader(path), ProcessorSimulatorException);
+    std::remove(path.c_str());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include "../src/conversion_engine.hpp"
+#include "../src/fixed_width_conversion.hpp"
+
+namespace {
+
+template <ConversionMode Mode, size_t Width>
+std::string convert(const std::string& bits) {
+    char out[FixedWidthConverter<Mode, Width>::kMaxOutputLength];
+    return std::string(out, FixedWidthConverter<Mode, Width>::convert(bits.data(), out));
+}
+
+template <size_t Width>
+void expectMatchesEngine(std::mt19937_64& rng) {
+    for (int trial = 0; trial < 200; ++trial) {
+        std::string bits(Width, '0');
+        for (char& c : bits) {
+            c = (rng() & 1) ? '1' : '0';
+        }
+        std::string expected(Width / 4, '\0');
+        ASSERT_TRUE(ConversionEngine::binaryToHex(bits.data(), bits.size(), &expected[0]));
+        EXPECT_EQ((convert<ConversionMode::STANDARD, Width>(bits)), expected);
+        EXPECT_EQ((convert<ConversionMode::UNSIGNED, Width>(bits)), expected);
+    }
+}
+
+} // namespace
+
+TEST(FixedWidthConversionTest, DigitModesMatchTheEngine) {
+    std::mt19937_64 rng(7);
+    expectMatchesEngine<8>(rng);
+    expectMatchesEngine<16>(rng);
+    expectMatchesEngine<32>(rng);
+    expectMatchesEngine<64>(rng);
+}
+
+TEST(FixedWidthConversionTest, FormatsRegisterValues) {
+    char out[16];
+    using Byte = FixedWidthConverter<ConversionMode::STANDARD, 8>;
+    using Word = FixedWidthConverter<ConversionMode::UNSIGNED, 64>;
+    EXPECT_EQ(std::string(out, Byte::format(0x1234, out)), "34");
+    EXPECT_EQ(std::string(out, Word::format(0xDEADBEEF0000002AULL, out)), "DEADBEEF0000002A");
+}
+
+TEST(FixedWidthConversionTest, SignedValues) {
+    EXPECT_EQ((convert<ConversionMode::SIGNED, 8>("11110000")), "FFFFFFF0");
+    EXPECT_EQ((convert<ConversionMode::SIGNED, 8>("00001010")), "A");
+    EXPECT_EQ((convert<ConversionMode::SIGNED, 8>("00000000")), "0");
+    EXPECT_EQ((convert<ConversionMode::SIGNED, 16>("1000000000000000")), "FFFF8000");
+    EXPECT_EQ((convert<ConversionMode::SIGNED, 32>("01111111111111111111111111111111")), "7FFFFFFF");
+    EXPECT_EQ((convert<ConversionMode::SIGNED, 64>(std::string(64, '1'))), "FFFFFFFFFFFFFFFF");
+    EXPECT_EQ((convert<ConversionMode::SIGNED, 64>("01" + std::string(62, '0'))), "4000000000000000");
+
+    char out[16];
+    using Int16 = FixedWidthConverter<ConversionMode::SIGNED, 16>;
+    EXPECT_EQ(std::string(out, Int16::format(static_cast<uint64_t>(-2), out)), "FFFFFFFE");
+}
+
+TEST(FixedWidthConversionTest, FloatingPoint) {
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 32>("01000001001000000000000000000000")), "1.000000E+01");
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 32>("11000000000000000000000000000000")), "-2.000000E+00");
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 32>("01111111100000000000000000000000")), "INF");
+
+    // binary16: 1.5, -65504 (largest finite), smallest subnormal
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 16>("0011111000000000")), "1.500000E+00");
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 16>("1111101111111111")), "-6.550400E+04");
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 16>("0000000000000001")), "5.960464E-08");
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 16>("0111110000000001")), "NAN");
+
+    // binary64: 10.0 and the largest finite double
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 64>(
+                  "0100000000100100000000000000000000000000000000000000000000000000")), "1.000000E+01");
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 64>("0111111111101111" + std::string(48, '1'))),
+              "1.797693E+308");
+}
+
+TEST(FixedWidthConversionTest, RejectsInvalidCharacters) {
+    EXPECT_EQ((convert<ConversionMode::STANDARD, 8>("1010102a")), "");
+    EXPECT_EQ((convert<ConversionMode::STANDARD, 64>(std::string(63, '1') + "2")), "");
+    EXPECT_EQ((convert<ConversionMode::FLOATING_POINT, 16>("0000000000000003")), "");
+    EXPECT_THROW(ProcessorSimulator::binaryToHex("1111111a"), ProcessorSimulatorException);
+}
+
+TEST(FixedWidthConversionTest, RuntimeEntryPointDispatchesToKernels) {
+    EXPECT_EQ(ProcessorSimulator::binaryToHex("00001010"), "0A");
+    EXPECT_EQ(ProcessorSimulator::binaryToHex("1111000011110000", ConversionMode::UNSIGNED), "F0F0");
+    EXPECT_EQ(ProcessorSimulator::binaryToHex("01000001001000000000000000000000", ConversionMode::FLOATING_POINT),
+              "1.000000E+01");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
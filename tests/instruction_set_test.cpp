@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "../src/instruction_set.hpp"
+#include "../src/processor_simulator.hpp"
+
+TEST(InstructionSetTest, EncodeDecodeRoundTrip) {
+    Instruction instruction;
+    instruction.op = Opcode::ADDI;
+    instruction.rd = 3;
+    instruction.rs1 = 15;
+    instruction.imm = -42;
+
+    Instruction decoded = Instruction::decode(instruction.encode());
+    EXPECT_EQ(decoded.op, Opcode::ADDI);
+    EXPECT_EQ(decoded.rd, 3);
+    EXPECT_EQ(decoded.rs1, 15);
+    EXPECT_EQ(decoded.rs2, 0);
+    EXPECT_EQ(decoded.imm, -42);
+}
+
+TEST(InstructionSetTest, InvalidWordsDecodeToIllegal) {
+    EXPECT_EQ(Instruction::decode(0xFF).op, Opcode::ILLEGAL);
+    EXPECT_EQ(Instruction::decode(static_cast<uint64_t>(Opcode::ILLEGAL)).op, Opcode::ILLEGAL);
+    // ADD with rd = 16
+    EXPECT_EQ(Instruction::decode(static_cast<uint64_t>(Opcode::ADD) | (16u << 8)).op, Opcode::ILLEGAL);
+}
+
+TEST(InstructionSetTest, AssemblesEachOperandFormat) {
+    Instruction add = InstructionSet::assemble("ADD R1, R2, R3");
+    EXPECT_EQ(add.op, Opcode::ADD);
+    EXPECT_EQ(add.rd, 1);
+    EXPECT_EQ(add.rs1, 2);
+    EXPECT_EQ(add.rs2, 3);
+
+    Instruction li = InstructionSet::assemble("  li r10, 0x7f  ; comment");
+    EXPECT_EQ(li.op, Opcode::LI);
+    EXPECT_EQ(li.rd, 10);
+    EXPECT_EQ(li.imm, 0x7F);
+
+    Instruction load = InstructionSet::assemble("LOAD R4, -16(R5)");
+    EXPECT_EQ(load.op, Opcode::LOAD);
+    EXPECT_EQ(load.rd, 4);
+    EXPECT_EQ(load.rs1, 5);
+    EXPECT_EQ(load.imm, -16);
+
+    Instruction store = InstructionSet::assemble("STORE R6, (R7)");
+    EXPECT_EQ(store.op, Opcode::STORE);
+    EXPECT_EQ(store.rs2, 6);
+    EXPECT_EQ(store.rs1, 7);
+    EXPECT_EQ(store.imm, 0);
+
+    Instruction cmpi = InstructionSet::assemble("CMPI R1, 0b1010");
+    EXPECT_EQ(cmpi.op, Opcode::CMPI);
+    EXPECT_EQ(cmpi.rs1, 1);
+    EXPECT_EQ(cmpi.imm, 10);
+
+    EXPECT_EQ(InstructionSet::assemble("HALT").op, Opcode::HALT);
+    EXPECT_EQ(InstructionSet::assemble("JMP 64").imm, 64);
+}
+
+TEST(InstructionSetTest, RejectsMalformedInstructions) {
+    EXPECT_THROW(InstructionSet::assemble("FOO R1"), ProcessorSimulatorException);
+    EXPECT_THROW(InstructionSet::assemble("ADD R1, R2"), ProcessorSimulatorException);
+    EXPECT_THROW(InstructionSet::assemble("ADD R1, R2, R16"), ProcessorSimulatorException);
+    EXPECT_THROW(InstructionSet::assemble("LI R1, 0x100000000"), ProcessorSimulatorException);
+    EXPECT_THROW(InstructionSet::assemble("LOAD R1, R2"), ProcessorSimulatorException);
+    EXPECT_THROW(InstructionSet::assemble("JMP loop"), ProcessorSimulatorException);
+    EXPECT_THROW(InstructionSet::assemble("HALT R1"), ProcessorSimulatorException);
+}
+
+TEST(InstructionSetTest, ResolvesLabelsAgainstTheBaseAddress) {
+    Program program = InstructionSet::assembleProgram(
+        "start:\n"
+        "    LI R1, 3      # counter\n"
+        "\n"
+        "loop: ADDI R1, R1, -1\n"
+        "    CMPI R1, 0\n"
+        "    BNE loop\n"
+        "    JMP start\n",
+        0x100);
+
+    ASSERT_EQ(program.code.size(), 5u);
+    EXPECT_EQ(program.base, 0x100u);
+    EXPECT_EQ(program.code[3].op, Opcode::BNE);
+    EXPECT_EQ(program.code[3].imm, 0x108);
+    EXPECT_EQ(program.code[4].imm, 0x100);
+    EXPECT_TRUE(program.contains(0x120));
+    EXPECT_FALSE(program.contains(0x128));
+}
+
+TEST(InstructionSetTest, ReportsTheFailingLine) {
+    try {
+        InstructionSet::assembleProgram("NOP\nNOP\nBOGUS\n");
+        FAIL() << "expected an exception";
+    } catch (const ProcessorSimulatorException& e) {
+        EXPECT_NE(std::string(e.what()).find("Line 3"), std::string::npos);
+    }
+    EXPECT_THROW(InstructionSet::assembleProgram("a: NOP\na: NOP\n"), ProcessorSimulatorException);
+}
+
+TEST(InstructionSetTest, DisassemblyReassembles) {
+    const char* lines[] = {"LI R1, -5", "MOV R2, R1", "SUB R3, R2, R1", "ADDI R4, R3, 8",
+                           "LOAD R5, 16(R4)", "STORE R5, -8(R4)", "CMP R1, R2", "CMPI R3, 7",
+                           "BGEU 24", "SYNC", "HALT"};
+    for (const char* line : lines) {
+        EXPECT_EQ(InstructionSet::disassemble(InstructionSet::assemble(line)), line);
+    }
+}
+
+TEST(InstructionSetTest, RegisterNames) {
+    EXPECT_EQ(InstructionSet::registerIndex("R0"), 0);
+    EXPECT_EQ(InstructionSet::registerIndex("r15"), 15);
+    EXPECT_EQ(InstructionSet::registerIndex("R16"), -1);
+    EXPECT_EQ(InstructionSet::registerIndex("R01"), -1);
+    EXPECT_EQ(InstructionSet::registerIndex("X1"), -1);
+    EXPECT_STREQ(InstructionSet::registerName(12), "R12");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
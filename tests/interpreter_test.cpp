@@ -0,0 +1,322 @@
+#include <gtest/gtest.h>
+#include "../src/interpreter.hpp"
+#include "../src/processor_simulator.hpp"
+
+class InterpreterTest : public ::testing::Test {
+protected:
+    ProcessorSimulator simulator;
+
+    uint64_t reg(size_t index) { return simulator.getState().readRegister(index); }
+};
+
+namespace {
+
+using State = ProcessorSimulator::ProcessorState;
+
+// One program run instruction by instruction, or through translated blocks
+struct Machine {
+    State state;
+    SimulatedMemory memory;
+    Program program;
+    BlockCache blocks;
+    std::string fault;
+
+    explicit Machine(const char* source) : program(InstructionSet::assembleProgram(source, 0)) {
+        for (size_t i = 0; i < program.code.size(); ++i) {
+            memory.store64(i * InstructionSet::kInstructionBytes, program.code[i].encode());
+        }
+    }
+
+    uint64_t run(uint64_t maxSteps, bool translated) {
+        try {
+            return translated ? Interpreter::run(state, memory, program, blocks, maxSteps)
+                              : Interpreter::run(state, memory, program, maxSteps);
+        } catch (const ProcessorSimulatorException& e) {
+            fault = e.what();
+            return 0;
+        }
+    }
+};
+
+void expectSameState(const Machine& actual, const Machine& expected) {
+    EXPECT_EQ(actual.state.getPc(), expected.state.getPc());
+    EXPECT_EQ(actual.state.getFlags(), expected.state.getFlags());
+    EXPECT_EQ(actual.state.isHalted(), expected.state.isHalted());
+    EXPECT_EQ(actual.fault, expected.fault);
+    for (size_t r = 0; r < InstructionSet::kRegisterCount; ++r) {
+        EXPECT_EQ(actual.state.readRegister(r), expected.state.readRegister(r)) << "R" << r;
+    }
+}
+
+// Runs `source` in slices of `slice` steps on both tiers, comparing after each
+void expectTiersAgree(const char* source, uint64_t slice) {
+    Machine plain(source);
+    Machine translated(source);
+    for (int i = 0; i < 10000 && !plain.state.isHalted() && plain.fault.empty(); ++i) {
+        uint64_t expected = plain.run(slice, false);
+        EXPECT_EQ(translated.run(slice, true), expected) << "slice " << i;
+        expectSameState(translated, plain);
+        if (::testing::Test::HasFailure()) {
+            return;
+        }
+    }
+    EXPECT_TRUE(plain.state.isHalted() || !plain.fault.empty());
+    EXPECT_GT(translated.blocks.blockCount(), 0u);
+}
+
+// Nested loops over every kind of ALU operation, compare and branch
+const char* const kMixedProgram =
+    "    LI R1, 0\n"
+    "    LI R2, 20\n"
+    "    LI R15, 3\n"
+    "outer:\n"
+    "    LI R3, 10\n"
+    "inner:\n"
+    "    ADD R1, R1, R3\n"
+    "    MUL R4, R1, R2\n"
+    "    XOR R5, R4, R1\n"
+    "    SHR R6, R5, R3\n"
+    "    SHL R7, R6, R2\n"
+    "    AND R8, R7, R5\n"
+    "    OR R9, R8, R6\n"
+    "    SUB R10, R9, R1\n"
+    "    NOP\n"
+    "    MOV R11, R10\n"
+    "    SHL R14, R3, R15\n"
+    "    STORE R11, 0x1000(R14)\n"
+    "    LOAD R12, 0x1000(R14)\n"
+    "    CMP R12, R1\n"
+    "    BLTU skip\n"
+    "    ADDI R13, R13, 1\n"
+    "skip:\n"
+    "    ADDI R3, R3, -1\n"
+    "    CMPI R3, 0\n"
+    "    BGE inner\n"
+    "    ADDI R2, R2, -1\n"
+    "    CMP R2, R0\n"
+    "    BNE outer\n"
+    "    HALT\n";
+
+} // namespace
+
+TEST_F(InterpreterTest, ExecutesSingleInstructions) {
+    simulator.executeInstruction("LI R1, 40");
+    simulator.executeInstruction("LI R2, 2");
+    simulator.executeInstruction("ADD R3, R1, R2");
+    EXPECT_EQ(reg(3), 42u);
+    EXPECT_EQ(simulator.getState().getRegister("R3"), 42u);
+    EXPECT_EQ(simulator.getState().getPc(), 24u);
+
+    // Repeated text is served from the decode cache
+    simulator.executeInstruction("ADD R3, R1, R2");
+    simulator.executeInstruction("ADD R3, R3, R2");
+    EXPECT_EQ(reg(3), 44u);
+}
+
+TEST_F(InterpreterTest, ArithmeticAndLogic) {
+    simulator.loadProgram(
+        "LI R1, -8\n"
+        "LI R2, 3\n"
+        "SUB R3, R2, R1\n"
+        "MUL R4, R1, R2\n"
+        "SHL R5, R2, R2\n"
+        "SHR R6, R1, R2\n"
+        "AND R7, R1, R2\n"
+        "OR R8, R1, R2\n"
+        "XOR R9, R1, R1\n"
+        "ADDI R10, R2, -4\n"
+        "MOV R11, R10\n"
+        "HALT\n");
+    EXPECT_EQ(simulator.run(), 12u);
+    EXPECT_TRUE(simulator.getState().isHalted());
+    EXPECT_EQ(reg(1), static_cast<uint64_t>(-8));
+    EXPECT_EQ(reg(3), 11u);
+    EXPECT_EQ(reg(4), static_cast<uint64_t>(-24));
+    EXPECT_EQ(reg(5), 24u);
+    EXPECT_EQ(reg(6), static_cast<uint64_t>(-8) >> 3);
+    EXPECT_EQ(reg(7), 0u);
+    EXPECT_EQ(reg(8), static_cast<uint64_t>(-5));
+    EXPECT_EQ(reg(9), 0u);
+    EXPECT_EQ(reg(11), static_cast<uint64_t>(-1));
+}
+
+TEST_F(InterpreterTest, LoopsWithBranches) {
+    // Sum of 1..100
+    simulator.loadProgram(
+        "    LI R1, 0\n"
+        "    LI R2, 100\n"
+        "loop:\n"
+        "    ADD R1, R1, R2\n"
+        "    ADDI R2, R2, -1\n"
+        "    CMPI R2, 0\n"
+        "    BNE loop\n"
+        "    HALT\n");
+    EXPECT_EQ(simulator.run(), 2u + 4u * 100u + 1u);
+    EXPECT_EQ(reg(1), 5050u);
+}
+
+TEST_F(InterpreterTest, SignedAndUnsignedComparisons) {
+    simulator.executeInstruction("LI R1, -1");
+    simulator.executeInstruction("LI R2, 1");
+    simulator.executeInstruction("CMP R1, R2");
+    uint8_t flags = simulator.getState().getFlags();
+    EXPECT_TRUE(flags & ProcessorSimulator::ProcessorState::kFlagNegative);  // -1 < 1
+    EXPECT_FALSE(flags & ProcessorSimulator::ProcessorState::kFlagCarry);    // 0xFFFF... > 1
+    EXPECT_FALSE(flags & ProcessorSimulator::ProcessorState::kFlagZero);
+
+    simulator.executeInstruction("BLT 800");
+    EXPECT_EQ(simulator.getState().getPc(), 800u);
+    simulator.executeInstruction("BLTU 0");
+    EXPECT_EQ(simulator.getState().getPc(), 808u);
+}
+
+TEST_F(InterpreterTest, LoadsAndStores) {
+    simulator.loadProgram(
+        "    LI R1, 0x1000\n"   // array base
+        "    LI R2, 0\n"        // index
+        "fill:\n"
+        "    MUL R3, R2, R2\n"
+        "    STORE R3, 0(R1)\n"
+        "    ADDI R1, R1, 8\n"
+        "    ADDI R2, R2, 1\n"
+        "    CMPI R2, 10\n"
+        "    BLT fill\n"
+        "    LOAD R4, -8(R1)\n"
+        "    HALT\n");
+    simulator.run();
+    EXPECT_EQ(reg(4), 81u);
+    EXPECT_EQ(simulator.getMemory().load64(0x1000 + 5 * 8), 25u);
+}
+
+TEST_F(InterpreterTest, ProgramIsWrittenToMemory) {
+    simulator.loadProgram("LI R1, 7\nHALT\n", 0x200);
+    EXPECT_EQ(simulator.getState().getPc(), 0x200u);
+    Instruction first = Instruction::decode(simulator.getMemory().load64(0x200));
+    EXPECT_EQ(first.op, Opcode::LI);
+    EXPECT_EQ(first.imm, 7);
+}
+
+TEST_F(InterpreterTest, SelfModifyingStoresAreSeen) {
+    // Overwrites the "LI R5, 1" at "patched" with the instruction word held in memory at 0x800
+    Instruction replacement = InstructionSet::assemble("LI R5, 99");
+    simulator.getMemory().store64(0x800, replacement.encode());
+    simulator.loadProgram(
+        "    LI R1, 0x800\n"
+        "    LOAD R2, 0(R1)\n"
+        "    LI R3, 32\n"
+        "    STORE R2, 0(R3)\n"
+        "patched:\n"
+        "    LI R5, 1\n"
+        "    HALT\n");
+    simulator.run();
+    EXPECT_EQ(reg(5), 99u);
+}
+
+TEST_F(InterpreterTest, StepBudgetStopsTheRun) {
+    simulator.loadProgram("loop: ADDI R1, R1, 1\nJMP loop\n");
+    EXPECT_EQ(simulator.run(1000), 1000u);
+    EXPECT_EQ(reg(1), 500u);
+    EXPECT_FALSE(simulator.getState().isHalted());
+    EXPECT_EQ(simulator.run(10), 10u);
+    EXPECT_EQ(reg(1), 505u);
+}
+
+TEST_F(InterpreterTest, ReportsExecutionErrors) {
+    simulator.loadProgram("JMP 4096\n");
+    EXPECT_THROW(simulator.run(), ProcessorSimulatorException);
+
+    simulator.loadProgram("LI R1, 4\nLOAD R2, 0(R1)\n");
+    EXPECT_THROW(simulator.run(), ProcessorSimulatorException);
+
+    EXPECT_THROW(simulator.executeInstruction("ADD R1"), ProcessorSimulatorException);
+    EXPECT_THROW(simulator.executeInstruction(""), ProcessorSimulatorException);
+}
+
+TEST_F(InterpreterTest, ResetClearsExecutionState) {
+    simulator.loadProgram("LI R1, 1\nCMP R1, R1\nHALT\n");
+    simulator.run();
+    simulator.getState().reset();
+    EXPECT_EQ(simulator.getState().getPc(), 0u);
+    EXPECT_EQ(simulator.getState().getFlags(), 0u);
+    EXPECT_FALSE(simulator.getState().isHalted());
+    EXPECT_THROW(simulator.getState().getRegister("R1"), ProcessorSimulatorException);
+}
+
+TEST_F(InterpreterTest, SyncIsANoOpOnASingleCore) {
+    simulator.loadProgram("LI R1, 1\nSYNC\nADDI R1, R1, 1\nHALT\n");
+    EXPECT_EQ(simulator.run(), 4u);
+    EXPECT_EQ(reg(1), 2u);
+}
+
+TEST(BlockTranslationTest, MatchesTheInterpreterAtAnyStepBudget) {
+    for (uint64_t slice : {1u, 7u, 63u, 64u, 65u, 1000u, 1000000u}) {
+        SCOPED_TRACE(slice);
+        expectTiersAgree(kMixedProgram, slice);
+    }
+}
+
+TEST(BlockTranslationTest, SelfModifyingStoresInvalidateBlocks) {
+    // After 40 iterations the loop rewrites its own "ADDI R4, R4, 1" into
+    // "ADDI R4, R4, 100", from the instruction word at 0x800
+    const char* source =
+        "    LI R1, 0x800\n"
+        "    LOAD R2, 0(R1)\n"
+        "    LI R1, 0\n"
+        "loop:\n"
+        "    ADDI R1, R1, 1\n"
+        "patched:\n"
+        "    ADDI R4, R4, 1\n"
+        "    CMPI R1, 40\n"
+        "    BNE next\n"
+        "    LI R3, 32\n"
+        "    STORE R2, 0(R3)\n"
+        "next:\n"
+        "    CMPI R1, 100\n"
+        "    BLT loop\n"
+        "    HALT\n";
+    Machine plain(source);
+    Machine translated(source);
+    uint64_t replacement = InstructionSet::assemble("ADDI R4, R4, 100").encode();
+    plain.memory.store64(0x800, replacement);
+    translated.memory.store64(0x800, replacement);
+
+    EXPECT_EQ(translated.run(100000, true), plain.run(100000, false));
+    expectSameState(translated, plain);
+    EXPECT_EQ(translated.state.readRegister(4), 40u + 60u * 100u);
+    EXPECT_GT(translated.blocks.blockCount(), 0u);
+}
+
+TEST(BlockTranslationTest, FaultsReportTheFaultingPc) {
+    // Loads from an unmapped-alignment address once the loop is hot
+    expectTiersAgree(
+        "    LI R1, 0\n"
+        "loop:\n"
+        "    ADDI R1, R1, 1\n"
+        "    CMPI R1, 50\n"
+        "    BNE aligned\n"
+        "    LOAD R2, 3(R1)\n"
+        "aligned:\n"
+        "    LOAD R2, 0x1000(R0)\n"
+        "    ADDI R3, R3, 7\n"
+        "    JMP loop\n",
+        1000000);
+}
+
+TEST(BlockTranslationTest, StopsAfterSync) {
+    Machine plain("loop: ADDI R1, R1, 1\nADDI R2, R2, 2\nSYNC\nJMP loop\n");
+    Machine translated("loop: ADDI R1, R1, 1\nADDI R2, R2, 2\nSYNC\nJMP loop\n");
+    EXPECT_EQ(translated.run(1000, true), 3u);
+    EXPECT_EQ(plain.run(1000, false), 3u);
+    for (int quantum = 0; quantum < 50; ++quantum) {
+        // JMP, ADDI, ADDI, SYNC
+        EXPECT_EQ(translated.run(1000, true), 4u);
+        EXPECT_EQ(plain.run(1000, false), 4u);
+        expectSameState(translated, plain);
+    }
+    EXPECT_GT(translated.blocks.blockCount(), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "../src/json_request_parser.hpp"
+
+class JsonRequestParserTest : public ::testing::Test {
+protected:
+    JsonRequestParser parser;
+    ConversionRequestFields request;
+};
+
+TEST_F(JsonRequestParserTest, ParsesFieldsInAnyOrderAndSpacing) {
+    ASSERT_TRUE(parser.parseRequest(R"({"binary":"1010","mode":"SIGNED"})", request));
+    EXPECT_EQ(request.binary, "1010");
+    EXPECT_EQ(request.mode, "SIGNED");
+
+    ASSERT_TRUE(parser.parseRequest(" \n{ \"mode\" :\t\"UNSIGNED\" ,\r\n \"binary\" : \"11\" } ", request));
+    EXPECT_EQ(request.binary, "11");
+    EXPECT_EQ(request.mode, "UNSIGNED");
+}
+
+TEST_F(JsonRequestParserTest, KeepsLegacyDefaults) {
+    ASSERT_TRUE(parser.parseRequest("{}", request));
+    EXPECT_EQ(request.binary, "1010");
+    EXPECT_EQ(request.mode, "STANDARD");
+}
+
+TEST_F(JsonRequestParserTest, SkipsUnknownMembers) {
+    ASSERT_TRUE(parser.parseRequest(
+        R"({"id": -12.5e+3, "tags": ["a", {"b": [true, false, null]}], "binary": "0110", "x": {}})",
+        request));
+    EXPECT_EQ(request.binary, "0110");
+}
+
+TEST_F(JsonRequestParserTest, DecodesEscapes) {
+    ASSERT_TRUE(parser.parseRequest(R"({"\u0062inary": "\u0031\u00300", "mode": "SIG\/NED"})", request));
+    EXPECT_EQ(request.binary, "100");
+    EXPECT_EQ(request.mode, "SIG/NED");
+
+    ASSERT_TRUE(parser.parseRequest(R"({"mode": "\ud83d\ude00\n"})", request));
+    EXPECT_EQ(request.mode, "\xF0\x9F\x98\x80\n");
+}
+
+TEST_F(JsonRequestParserTest, DoesNotMatchKeysInsideValues) {
+    ASSERT_TRUE(parser.parseRequest(R"({"note": "\"binary\": \"1111\"", "binary": "0"})", request));
+    EXPECT_EQ(request.binary, "0");
+}
+
+TEST_F(JsonRequestParserTest, RejectsMalformedBodies) {
+    for (const char* body : {"", "[]", "{", "{\"binary\": \"1010\"", "{\"binary\" \"1010\"}",
+                             "{\"binary\": 1010}", "{\"binary\": \"10\n10\"}", "{\"a\": tru}",
+                             "{\"a\": 01}", "{\"a\": \"\\x\"}", "{\"a\": 1,}", "{} {}",
+                             "{\"binary\": \"1\\u12\"}"}) {
+        EXPECT_FALSE(parser.parseRequest(body, request)) << body;
+        EXPECT_STRNE(parser.error(), "") << body;
+    }
+}
+
+TEST_F(JsonRequestParserTest, RejectsDeepNesting) {
+    std::string body = "{\"a\": " + std::string(100, '[') + std::string(100, ']') + "}";
+    EXPECT_FALSE(parser.parseRequest(body, request));
+}
+
+TEST_F(JsonRequestParserTest, ParsesBatches) {
+    std::vector<ConversionRequestFields> items;
+    ASSERT_TRUE(parser.parseBatch(
+        R"({"items": [{"binary": "1"}, {"binary": "\u0030", "mode": "SIGNED"}, {}], "id": 7})", items, 10));
+    ASSERT_EQ(items.size(), 3u);
+    EXPECT_EQ(items[0].binary, "1");
+    EXPECT_EQ(items[1].binary, "0");
+    EXPECT_EQ(items[1].mode, "SIGNED");
+    EXPECT_EQ(items[2].binary, "1010");
+
+    EXPECT_FALSE(parser.parseBatch(R"({"items": [{}, {}, {}]})", items, 2));
+    EXPECT_TRUE(parser.tooManyItems());
+
+    EXPECT_FALSE(parser.parseBatch(R"({"values": []})", items, 2));
+    EXPECT_FALSE(parser.tooManyItems());
+    EXPECT_FALSE(parser.parseBatch(R"({"items": [1]})", items, 2));
+
+    // An escaped key names the same member
+    ASSERT_TRUE(parser.parseBatch(R"({"\u0069tems": [{"binary": "11"}]})", items, 2));
+    ASSERT_EQ(items.size(), 1u);
+    EXPECT_EQ(items[0].binary, "11");
+}
+
+TEST(JsonEscapeTest, EscapesSpecialCharacters) {
+    std::string out;
+    appendJsonEscaped(out, std::string("a\"b\\c\n\x01z", 8));
+    EXPECT_EQ(out, "a\\\"b\\\\c\\n\\u0001z");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include "../src/conversion_engine.hpp"
+#include "../src/mapped_file.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+std::string tempPath(const std::string& name) {
+    return ::testing::TempDir() + name;
+}
+
+} // namespace
+
+TEST(MappedFileTest, ConvertsDirectlyBetweenMappings) {
+    std::string binary;
+    for (int i = 0; i < 100003; ++i) {
+        binary += (i * 7 % 3 == 0) ? '1' : '0';
+    }
+    std::string inputPath = tempPath("mapped_input.txt");
+    std::string outputPath = tempPath("mapped_output.txt");
+    std::ofstream(inputPath, std::ios::binary) << binary;
+
+    {
+        MappedFile input(inputPath);
+        ASSERT_EQ(input.size(), binary.size());
+
+        MappedOutputFile output(outputPath, ConversionEngine::hexLength(input.size()));
+        ProcessorSimulator simulator;
+        simulator.multiThreadedBinaryToHex(std::string_view(input.data(), input.size()), output.data());
+    }
+
+    std::ifstream result(outputPath, std::ios::binary);
+    std::string hex((std::istreambuf_iterator<char>(result)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(hex, ProcessorSimulator::binaryToHex(binary));
+
+    std::remove(inputPath.c_str());
+    std::remove(outputPath.c_str());
+}
+
+TEST(MappedFileTest, EmptyFileMapsToEmptyView) {
+    std::string path = tempPath("mapped_empty.txt");
+    std::ofstream(path, std::ios::binary).close();
+    MappedFile input(path);
+    EXPECT_EQ(input.size(), 0u);
+    std::remove(path.c_str());
+}
+
+TEST(MappedFileTest, DiscardRemovesOutput) {
+    std::string path = tempPath("mapped_discard.txt");
+    MappedOutputFile output(path, 16);
+    output.discard();
+    EXPECT_FALSE(std::ifstream(path).good());
+}
+
+TEST(MappedFileTest, MissingFileThrows) {
+    EXPECT_THROW(MappedFile(tempPath("does_not_exist.txt")), ProcessorSimulatorException);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "../src/multi_core_simulator.hpp"
+#include "../src/thread_pool.hpp"
+
+namespace {
+
+// Sums 1..R1 into R2, then stores the sum at 0x1000 + 8 * R3
+const char* kSumProgram =
+    "    LI R2, 0\n"
+    "loop:\n"
+    "    ADD R2, R2, R1\n"
+    "    ADDI R1, R1, -1\n"
+    "    CMPI R1, 0\n"
+    "    BNE loop\n"
+    "    LI R4, 8\n"
+    "    MUL R4, R3, R4\n"
+    "    STORE R2, 0x1000(R4)\n"
+    "    HALT\n";
+
+} // namespace
+
+TEST(MultiCoreSimulatorTest, CoresRunIndependently) {
+    ThreadPool pool(4);
+    MultiCoreSimulator simulator(pool);
+    simulator.setQuantum(7);
+    size_t first = simulator.addCores(64, kSumProgram);
+    for (size_t i = 0; i < 64; ++i) {
+        simulator.core(first + i).state.writeRegister(1, i + 1);
+        simulator.core(first + i).state.writeRegister(3, i);
+    }
+
+    simulator.run();
+    EXPECT_EQ(simulator.runningCores(), 0u);
+    EXPECT_GT(simulator.getEpochs(), 1u);
+    for (uint64_t i = 0; i < 64; ++i) {
+        EXPECT_TRUE(simulator.core(i).state.isHalted());
+        EXPECT_EQ(simulator.core(i).state.readRegister(2), (i + 1) * (i + 2) / 2);
+        EXPECT_EQ(simulator.getMemory().load64(0x1000 + 8 * i), (i + 1) * (i + 2) / 2);
+    }
+}
+
+TEST(MultiCoreSimulatorTest, StoresBecomeVisibleAfterSync) {
+    MultiCoreSimulator simulator;
+    simulator.addCore(
+        "    LI R1, 42\n"
+        "    STORE R1, 0x2000(R0)\n"
+        "    SYNC\n"
+        "    HALT\n", 0x0);
+    simulator.addCore(
+        "    LOAD R1, 0x2000(R0)\n"  // Same epoch: still the old value
+        "    SYNC\n"
+        "    LOAD R2, 0x2000(R0)\n"
+        "    HALT\n", 0x100);
+
+    EXPECT_EQ(simulator.runEpoch(), 5u);
+    EXPECT_EQ(simulator.getMemory().load64(0x2000), 42u);
+    simulator.run();
+    EXPECT_EQ(simulator.core(1).state.readRegister(1), 0u);
+    EXPECT_EQ(simulator.core(1).state.readRegister(2), 42u);
+}
+
+TEST(MultiCoreSimulatorTest, ConflictingStoresAreDeterministic) {
+    // Every core repeatedly stores its own id to the same word
+    const char* program =
+        "loop:\n"
+        "    STORE R1, 0x3000(R0)\n"
+        "    ADDI R2, R2, 1\n"
+        "    CMPI R2, 100\n"
+        "    BNE loop\n"
+        "    HALT\n";
+
+    for (unsigned threads : {1u, 2u, 8u}) {
+        ThreadPool pool(threads);
+        MultiCoreSimulator simulator(pool);
+        simulator.setQuantum(13);
+        simulator.addCores(32, program);
+        for (size_t i = 0; i < 32; ++i) {
+            simulator.core(i).state.writeRegister(1, i);
+        }
+        EXPECT_EQ(simulator.run(), 32u * 401);
+        EXPECT_EQ(simulator.getMemory().load64(0x3000), 31u);  // Highest core wins
+    }
+}
+
+TEST(MultiCoreSimulatorTest, FaultsStopOnlyTheFaultingCore) {
+    MultiCoreSimulator simulator;
+    simulator.addCore("LI R1, 4\nLOAD R2, 0(R1)\nHALT\n", 0x0);
+    simulator.addCore("LI R1, 5\nHALT\n", 0x100);
+
+    simulator.run();
+    EXPECT_NE(simulator.core(0).fault.find("Misaligned"), std::string::npos);
+    EXPECT_FALSE(simulator.core(0).state.isHalted());
+    EXPECT_TRUE(simulator.core(1).fault.empty());
+    EXPECT_EQ(simulator.core(1).state.readRegister(1), 5u);
+    EXPECT_EQ(simulator.runningCores(), 0u);
+    EXPECT_EQ(simulator.core(0).steps, 1u);
+    EXPECT_EQ(simulator.core(1).steps, 2u);
+}
+
+TEST(MultiCoreSimulatorTest, FaultInATranslatedBlockKeepsEarlierSteps) {
+    // The 100th pass faults on the LOAD, second in a hot block
+    MultiCoreSimulator simulator;
+    simulator.addCore(
+        "loop:\n"
+        "    ADDI R1, R1, 1\n"
+        "    CMPI R1, 100\n"
+        "    BNE aligned\n"
+        "    LI R5, 4\n"
+        "aligned:\n"
+        "    ADDI R6, R6, 1\n"
+        "    LOAD R2, 0x2000(R5)\n"
+        "    JMP loop\n");
+
+    EXPECT_EQ(simulator.run(), 99u * 6 + 5);
+    EXPECT_EQ(simulator.core(0).steps, 99u * 6 + 5);
+    EXPECT_FALSE(simulator.core(0).fault.empty());
+    EXPECT_EQ(simulator.core(0).state.readRegister(6), 100u);
+}
+
+TEST(MultiCoreSimulatorTest, RejectsAnEmptyQuantum) {
+    MultiCoreSimulator simulator;
+    EXPECT_THROW(simulator.setQuantum(0), ProcessorSimulatorException);
+    EXPECT_EQ(simulator.getQuantum(), MultiCoreSimulator::kDefaultQuantum);
+}
+
+TEST(MultiCoreSimulatorTest, StepLimitPerCore) {
+    MultiCoreSimulator simulator;
+    simulator.setQuantum(3);
+    simulator.addCores(4, "loop: ADDI R1, R1, 1\nJMP loop\n");
+
+    EXPECT_EQ(simulator.run(10), 40u);
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_EQ(simulator.core(i).steps, 10u);
+        EXPECT_EQ(simulator.core(i).state.readRegister(1), 5u);
+    }
+    EXPECT_EQ(simulator.runningCores(), 4u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include "../src/packed_bits.hpp"
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+std::string randomBinary(std::mt19937& rng, size_t length) {
+    std::string binary(length, '0');
+    for (char& c : binary) {
+        c = (rng() & 1) ? '1' : '0';
+    }
+    return binary;
+}
+
+} // namespace
+
+TEST(PackedBitsTest, PacksMostSignificantBitFirst) {
+    PackedBits packed = PackedBits::fromAscii("1011");
+    ASSERT_EQ(packed.size(), 4u);
+    EXPECT_EQ(packed.data()[0], 0xB000000000000000ULL);
+    EXPECT_TRUE(packed.bit(0));
+    EXPECT_FALSE(packed.bit(1));
+
+    PackedBits word = PackedBits::fromAscii(std::string(63, '0') + "1" + "1");
+    EXPECT_EQ(word.data()[0], 1u);
+    EXPECT_EQ(word.data()[1], 0x8000000000000000ULL);
+}
+
+TEST(PackedBitsTest, AsciiRoundTripsForAllLengths) {
+    std::mt19937 rng(3);
+    for (size_t length = 0; length <= 200; ++length) {
+        std::string binary = randomBinary(rng, length);
+        EXPECT_EQ(PackedBits::fromAscii(binary).toAsciiString(), binary) << "length " << length;
+    }
+}
+
+TEST(PackedBitsTest, HexMatchesBinaryToHexForAllLengths) {
+    std::mt19937 rng(5);
+    for (size_t length = 1; length <= 200; ++length) {
+        std::string binary = randomBinary(rng, length);
+        EXPECT_EQ(PackedBits::fromAscii(binary).toHexString(), ProcessorSimulator::binaryToHex(binary))
+            << "length " << length;
+    }
+}
+
+TEST(PackedBitsTest, FromHexString) {
+    PackedBits packed = PackedBits::fromHexString("DEADbeef0123456789");
+    EXPECT_EQ(packed.size(), 72u);
+    EXPECT_EQ(packed.data()[0], 0xDEADBEEF01234567ULL);
+    EXPECT_EQ(packed.data()[1], 0x8900000000000000ULL);
+    EXPECT_EQ(packed.toHexString(), "DEADBEEF0123456789");
+    EXPECT_EQ(packed.toAsciiString(), ProcessorSimulator::hexToBinary("DEADBEEF0123456789"));
+}
+
+TEST(PackedBitsTest, FromBytesHonoursTheBitCount) {
+    const unsigned char bytes[] = {0xA5, 0xFF, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0xFF};
+    PackedBits all = PackedBits::fromBytes(bytes, 80);
+    EXPECT_EQ(all.toHexString(), "A5FF01020304050607FF");
+
+    // 12 bits: the rest of the second byte is dropped
+    PackedBits partial = PackedBits::fromBytes(bytes, 12);
+    EXPECT_EQ(partial.toAsciiString(), "101001011111");
+    EXPECT_EQ(partial.data()[0], 0xA5F0000000000000ULL);
+    EXPECT_EQ(partial.toHexString(), "A5F");
+}
+
+TEST(PackedBitsTest, RejectsInvalidInput) {
+    EXPECT_THROW(PackedBits::fromAscii("0102"), ProcessorSimulatorException);
+    EXPECT_THROW(PackedBits::fromAscii(std::string(64, '1') + "x"), ProcessorSimulatorException);
+    EXPECT_THROW(PackedBits::fromHexString("12G4"), ProcessorSimulatorException);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,28 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include "../src/processor_simulator.hpp"
 
+// Counts heap allocations so the buffer API can be checked to make none
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
 class ProcessorSimulatorTest : public ::testing::Test {
 protected:
     ProcessorSimulator simulator;
@@ -78,6 +100,81 @@ TEST_F(ProcessorSimulatorTest, ProcessorStateManagement) {
     EXPECT_THROW(state.getRegister("R1"), ProcessorSimulatorException);
 }
 
+TEST_F(ProcessorSimulatorTest, RegisterFileByIndexAndName) {
+    ProcessorSimulator::ProcessorState& state = simulator.getState();
+
+    // Name and index address the same architectural register
+    state.writeRegister(7, 99);
+    EXPECT_EQ(state.getRegister("R7"), 99);
+    state.setRegister("r7", 5);
+    EXPECT_EQ(state.readRegister(7), 5);
+
+    // Unwritten registers read as zero by index but are missing by name
+    EXPECT_EQ(state.readRegister(3), 0);
+    EXPECT_THROW(state.getRegister("R3"), ProcessorSimulatorException);
+
+    // Other names are kept separately
+    state.setRegister("ACC", 123);
+    EXPECT_EQ(state.getRegister("ACC"), 123);
+
+    state.reset();
+    EXPECT_EQ(state.readRegister(7), 0);
+    EXPECT_THROW(state.getRegister("ACC"), ProcessorSimulatorException);
+}
+
+TEST_F(ProcessorSimulatorTest, BufferOverloadsMatchStringResults) {
+    const ConversionMode modes[] = {ConversionMode::STANDARD, ConversionMode::SIGNED,
+                                    ConversionMode::UNSIGNED, ConversionMode::FLOATING_POINT};
+    const std::string inputs[] = {"", "1", "0000", "0011010", "11110000",
+                                  "0100000001001001000011111101101111110000010000000000000000000000",
+                                  std::string(100, '1'), "0" + std::string(70, '1')};
+    for (ConversionMode mode : modes) {
+        for (const std::string& input : inputs) {
+            if (mode == ConversionMode::FLOATING_POINT && input.size() > 32 && input.size() != 64) {
+                continue;
+            }
+            std::string expected = ProcessorSimulator::binaryToHex(input, mode);
+            char buffer[64];
+            ASSERT_LE(expected.size(), ProcessorSimulator::maxHexLength(input.size(), mode));
+            size_t length = ProcessorSimulator::binaryToHex(input, mode, buffer, sizeof(buffer));
+            EXPECT_EQ(std::string(buffer, length), expected) << input;
+            EXPECT_EQ(simulator.multiThreadedBinaryToHex(input, mode, buffer, sizeof(buffer)), length);
+        }
+    }
+}
+
+TEST_F(ProcessorSimulatorTest, BufferOverloadsReportRequiredSize) {
+    char buffer[8] = {'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x'};
+
+    // Too small: the required length comes back and nothing is written
+    EXPECT_EQ(ProcessorSimulator::binaryToHex("111100001010", ConversionMode::STANDARD, buffer, 2), 3u);
+    EXPECT_EQ(ProcessorSimulator::binaryToHex("1111", ConversionMode::SIGNED, buffer, 4), 8u);
+    EXPECT_EQ(ProcessorSimulator::hexToBinary("A5", buffer, 7), 8u);
+    EXPECT_EQ(std::string(buffer, 8), "xxxxxxxx");
+
+    EXPECT_EQ(ProcessorSimulator::hexToBinary("a5", buffer, sizeof(buffer)), 8u);
+    EXPECT_EQ(std::string(buffer, 8), "10100101");
+    EXPECT_THROW(ProcessorSimulator::hexToBinary("G0", buffer, sizeof(buffer)), ProcessorSimulatorException);
+    EXPECT_THROW(ProcessorSimulator::binaryToHex("10102", ConversionMode::STANDARD, buffer, sizeof(buffer)),
+                 ProcessorSimulatorException);
+}
+
+TEST_F(ProcessorSimulatorTest, BufferOverloadsDoNotAllocate) {
+    std::string wide(4096, '1');
+    std::string hex(wide.size() / 4, '0');
+    char out[1024];
+    char bits[16 * 1024];
+
+    size_t before = allocationCount.load();
+    ProcessorSimulator::binaryToHex(wide, ConversionMode::STANDARD, out, sizeof(out));
+    ProcessorSimulator::binaryToHex(wide, ConversionMode::SIGNED, out, sizeof(out));
+    ProcessorSimulator::binaryToHex(std::string_view(wide).substr(0, 64), ConversionMode::UNSIGNED, out, sizeof(out));
+    ProcessorSimulator::binaryToHex(std::string_view(wide).substr(0, 32), ConversionMode::FLOATING_POINT,
+                                    out, sizeof(out));
+    ProcessorSimulator::hexToBinary(hex, bits, sizeof(bits));
+    EXPECT_EQ(allocationCount.load(), before);
+}
+
 TEST_F(ProcessorSimulatorTest, ErrorHandling) {
     // Test invalid binary input throws an exception
     EXPECT_THROW(
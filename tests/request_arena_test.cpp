@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/json_request_parser.hpp"
+#include "../src/request_arena.hpp"
+
+TEST(RequestArenaTest, ReusesTheBlockAcrossScopes) {
+    void* first;
+    {
+        RequestArena::Scope arena;
+        first = arena.resource()->allocate(256, 8);
+    }
+    RequestArena::Scope arena;
+    EXPECT_EQ(arena.resource()->allocate(256, 8), first);
+}
+
+TEST(RequestArenaTest, GrowsToTheHighWaterMark) {
+    std::thread([] {
+        EXPECT_EQ(RequestArena::retainedBytes(), RequestArena::kInitialBytes);
+        {
+            RequestArena::Scope arena;
+            std::pmr::vector<char> large(RequestArena::kInitialBytes * 3, arena.resource());
+        }
+        EXPECT_GE(RequestArena::retainedBytes(), RequestArena::kInitialBytes * 3);
+
+        {
+            RequestArena::Scope arena;
+            std::pmr::vector<char> huge(RequestArena::kMaxRetainedBytes * 2, arena.resource());
+        }
+        EXPECT_EQ(RequestArena::retainedBytes(), RequestArena::kMaxRetainedBytes);
+    }).join();
+}
+
+TEST(RequestArenaTest, NestedScopesDoNotShareTheBlock) {
+    RequestArena::Scope outer;
+    std::pmr::string kept(100, 'a', outer.resource());
+    {
+        RequestArena::Scope inner;
+        std::pmr::string scratch(100, 'b', inner.resource());
+        EXPECT_EQ(std::string_view(scratch), std::string(100, 'b'));
+    }
+    EXPECT_EQ(std::string_view(kept), std::string(100, 'a'));
+}
+
+TEST(RequestArenaTest, ParsesBatchesIntoTheArena) {
+    JsonRequestParser parser;
+    RequestArena::Scope arena;
+    std::pmr::vector<ConversionRequestFields> items(arena.resource());
+    ASSERT_TRUE(parser.parseBatch(R"({"items": [{"binary": "1"}, {"mode": "SIGNED"}]})", items, 10));
+    ASSERT_EQ(items.size(), 2u);
+    EXPECT_EQ(items[0].binary, "1");
+    EXPECT_EQ(items[1].mode, "SIGNED");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
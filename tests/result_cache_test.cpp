@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/result_cache.hpp"
+
+TEST(ResultCacheTest, CountsHitsAndMisses) {
+    ConversionResultCache cache(1024 * 1024);
+    EXPECT_EQ(*cache.convert(ConversionMode::STANDARD, "11111111"), "FF");
+    EXPECT_EQ(*cache.convert(ConversionMode::STANDARD, "11111111"), "FF");
+    EXPECT_EQ(*cache.convert(ConversionMode::STANDARD, "1010"), "A");
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 2u);
+    EXPECT_EQ(cache.entryCount(), 2u);
+    EXPECT_GT(cache.memoryUsage(), 0u);
+}
+
+TEST(ResultCacheTest, HitReturnsTheSameString) {
+    ConversionResultCache cache(1024 * 1024);
+    ConversionResultCache::Result first = cache.convert(ConversionMode::UNSIGNED, "10101010");
+    ConversionResultCache::Result second = cache.convert(ConversionMode::UNSIGNED, "10101010");
+    EXPECT_EQ(first.get(), second.get());
+}
+
+TEST(ResultCacheTest, ModeIsPartOfTheKey) {
+    ConversionResultCache cache(1024 * 1024);
+    cache.convert(ConversionMode::STANDARD, "00001010");
+    EXPECT_EQ(cache.find(ConversionMode::UNSIGNED, "00001010"), nullptr);
+    EXPECT_NE(cache.find(ConversionMode::STANDARD, "00001010"), nullptr);
+}
+
+TEST(ResultCacheTest, EvictsLeastRecentlyUsedWithinBudget) {
+    // Room for a handful of small entries per shard
+    ConversionResultCache cache(ConversionResultCache::kShardCount * 1024);
+    for (int i = 0; i < 2000; ++i) {
+        std::string input(32, '0');
+        for (int bit = 0; bit < 16; ++bit) {
+            input[31 - bit] = (i >> bit) & 1 ? '1' : '0';
+        }
+        cache.convert(ConversionMode::STANDARD, input);
+        EXPECT_LE(cache.memoryUsage(), cache.memoryBudget());
+    }
+    EXPECT_LT(cache.entryCount(), 2000u);
+    EXPECT_GT(cache.entryCount(), 0u);
+}
+
+TEST(ResultCacheTest, RecentlyUsedEntrySurvivesEviction) {
+    ConversionResultCache cache(ConversionResultCache::kShardCount * 1024);
+    const std::string hot = "11110000111100001111000011110000";
+    cache.convert(ConversionMode::STANDARD, hot);
+    for (int i = 0; i < 2000; ++i) {
+        std::string input(32, '0');
+        for (int bit = 0; bit < 16; ++bit) {
+            input[31 - bit] = (i >> bit) & 1 ? '1' : '0';
+        }
+        cache.convert(ConversionMode::UNSIGNED, input);
+        ASSERT_NE(cache.find(ConversionMode::STANDARD, hot), nullptr);
+    }
+}
+
+TEST(ResultCacheTest, LargeInputsAreNotCached) {
+    ConversionResultCache cache(ConversionResultCache::kShardCount * 1024);
+    std::string large(4096, '1');
+    EXPECT_EQ(cache.convert(ConversionMode::STANDARD, large)->size(), 1024u);
+    EXPECT_EQ(cache.entryCount(), 0u);
+}
+
+TEST(ResultCacheTest, ErrorsAreNotCached) {
+    ConversionResultCache cache(1024 * 1024);
+    EXPECT_THROW(cache.convert(ConversionMode::STANDARD, "10201"), ProcessorSimulatorException);
+    EXPECT_EQ(cache.entryCount(), 0u);
+}
+
+TEST(ResultCacheTest, ZeroBudgetDisablesCaching) {
+    ConversionResultCache cache(0);
+    EXPECT_EQ(*cache.convert(ConversionMode::STANDARD, "1111"), "F");
+    EXPECT_EQ(*cache.convert(ConversionMode::STANDARD, "1111"), "F");
+    EXPECT_EQ(cache.entryCount(), 0u);
+    EXPECT_EQ(cache.hits(), 0u);
+}
+
+TEST(ResultCacheTest, ConcurrentAccess) {
+    ConversionResultCache cache(ConversionResultCache::kShardCount * 4096);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                int value = (i * 7 + t) % 300;
+                std::string input(12, '0');
+                for (int bit = 0; bit < 12; ++bit) {
+                    input[11 - bit] = (value >> bit) & 1 ? '1' : '0';
+                }
+                std::string expected = ProcessorSimulator::binaryToHex(input, ConversionMode::STANDARD);
+                ASSERT_EQ(*cache.convert(ConversionMode::STANDARD, input), expected);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(cache.hits() + cache.misses(), 16000u);
+    EXPECT_GT(cache.hits(), 0u);
+    EXPECT_LE(cache.memoryUsage(), cache.memoryBudget());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
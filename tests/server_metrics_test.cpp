@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "../src/server_metrics.hpp"
+
+namespace {
+
+bool contains(const std::string& text, const std::string& line) {
+    return text.find(line + "\n") != std::string::npos;
+}
+
+} // namespace
+
+TEST(ServerMetricsTest, CountsConversionsByModeAndOutcome) {
+    ServerMetrics metrics;
+    metrics.recordConversion(ServerMetrics::kindOf(ConversionMode::SIGNED), ServerMetrics::Outcome::OK, 8);
+    metrics.recordConversion(ServerMetrics::kindOf(ConversionMode::SIGNED), ServerMetrics::Outcome::OK, 100);
+    metrics.recordConversion(ServerMetrics::RequestKind::UNKNOWN, ServerMetrics::Outcome::BAD_REQUEST, 0);
+
+    std::string text = metrics.renderPrometheus({});
+    EXPECT_TRUE(contains(text, "processor_conversions_total{mode=\"SIGNED\",outcome=\"ok\"} 2"));
+    EXPECT_TRUE(contains(text, "processor_conversions_total{mode=\"unknown\",outcome=\"bad_request\"} 1"));
+    EXPECT_TRUE(contains(text, "processor_conversions_total{mode=\"STANDARD\",outcome=\"ok\"} 0"));
+
+    // 8 bits falls in the le=16 bucket, 100 bits in le=256; buckets are cumulative
+    EXPECT_TRUE(contains(text, "processor_conversion_input_bits_bucket{mode=\"SIGNED\",le=\"4\"} 0"));
+    EXPECT_TRUE(contains(text, "processor_conversion_input_bits_bucket{mode=\"SIGNED\",le=\"16\"} 1"));
+    EXPECT_TRUE(contains(text, "processor_conversion_input_bits_bucket{mode=\"SIGNED\",le=\"256\"} 2"));
+    EXPECT_TRUE(contains(text, "processor_conversion_input_bits_sum{mode=\"SIGNED\"} 108"));
+    EXPECT_TRUE(contains(text, "processor_conversion_input_bits_count{mode=\"SIGNED\"} 2"));
+}
+
+TEST(ServerMetricsTest, RecordsLatencyInSeconds) {
+    ServerMetrics metrics;
+    metrics.recordLatency(ServerMetrics::RequestKind::FLOATING_POINT, std::chrono::microseconds(40));
+    metrics.recordLatency(ServerMetrics::RequestKind::FLOATING_POINT, std::chrono::seconds(3));
+
+    std::string text = metrics.renderPrometheus({});
+    EXPECT_TRUE(contains(text, "processor_request_duration_seconds_bucket{mode=\"FLOATING_POINT\",le=\"5e-05\"} 1"));
+    EXPECT_TRUE(contains(text, "processor_request_duration_seconds_bucket{mode=\"FLOATING_POINT\",le=\"1\"} 1"));
+    EXPECT_TRUE(contains(text, "processor_request_duration_seconds_bucket{mode=\"FLOATING_POINT\",le=\"+Inf\"} 2"));
+    EXPECT_TRUE(contains(text, "processor_request_duration_seconds_sum{mode=\"FLOATING_POINT\"} 3.00004"));
+}
+
+TEST(ServerMetricsTest, TracksInFlightAndGauges) {
+    ServerMetrics metrics;
+    {
+        ServerMetrics::InFlight first(metrics);
+        ServerMetrics::InFlight second(metrics);
+        EXPECT_TRUE(contains(metrics.renderPrometheus({}), "processor_in_flight_requests 2"));
+    }
+    ServerMetrics::Gauges gauges;
+    gauges.threadPoolQueueDepth = 7;
+    gauges.threadPoolThreads = 32;
+    std::string text = metrics.renderPrometheus(gauges);
+    EXPECT_TRUE(contains(text, "processor_in_flight_requests 0"));
+    EXPECT_TRUE(contains(text, "processor_thread_pool_queue_depth 7"));
+    EXPECT_TRUE(contains(text, "processor_thread_pool_threads 32"));
+}
+
+TEST(ServerMetricsTest, SumsShardsAcrossThreads) {
+    ServerMetrics metrics;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 20; ++t) {
+        threads.emplace_back([&metrics]() {
+            for (int i = 0; i < 1000; ++i) {
+                metrics.recordConversion(ServerMetrics::RequestKind::STANDARD, ServerMetrics::Outcome::OK, 4);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(contains(metrics.renderPrometheus({}),
+                         "processor_conversions_total{mode=\"STANDARD\",outcome=\"ok\"} 20000"));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
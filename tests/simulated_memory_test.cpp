@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "../src/processor_simulator.hpp"
+#include "../src/simulated_memory.hpp"
+
+TEST(SimulatedMemoryTest, UntouchedMemoryReadsZero) {
+    SimulatedMemory memory;
+    EXPECT_EQ(memory.load64(0), 0u);
+    EXPECT_EQ(memory.load64(0xFFFFFFFFFFFFFFF8ULL), 0u);
+    EXPECT_EQ(memory.pageCount(), 0u);
+}
+
+TEST(SimulatedMemoryTest, StoresAllocatePagesLazily) {
+    SimulatedMemory memory;
+    memory.store64(8, 42);
+    memory.store64(16, 43);
+    memory.store64(1ULL << 40, 7);
+    EXPECT_EQ(memory.load64(8), 42u);
+    EXPECT_EQ(memory.load64(16), 43u);
+    EXPECT_EQ(memory.load64(1ULL << 40), 7u);
+    EXPECT_EQ(memory.pageCount(), 2u);
+
+    memory.clear();
+    EXPECT_EQ(memory.load64(8), 0u);
+}
+
+TEST(SimulatedMemoryTest, RejectsMisalignedWords) {
+    SimulatedMemory memory;
+    EXPECT_THROW(memory.load64(4), ProcessorSimulatorException);
+    EXPECT_THROW(memory.store64(1, 0), ProcessorSimulatorException);
+}
+
+TEST(SimulatedMemoryTest, ByteCopiesSpanPages) {
+    SimulatedMemory memory;
+    std::vector<unsigned char> data(10000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<unsigned char>(i * 31);
+    }
+    memory.write(SimulatedMemory::kPageBytes - 3, data.data(), data.size());
+
+    std::vector<unsigned char> back(data.size() + 16);
+    memory.read(SimulatedMemory::kPageBytes - 11, back.data(), back.size());
+    for (size_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(back[i], 0);
+    }
+    EXPECT_EQ(std::memcmp(back.data() + 8, data.data(), data.size()), 0);
+
+    uint64_t word;
+    std::memcpy(&word, data.data() + 3, sizeof(word));
+    EXPECT_EQ(memory.load64(SimulatedMemory::kPageBytes), word);
+}
+
+TEST(SimulatedMemoryTest, OverlayReadsThroughAndCommitsWrittenWords) {
+    SimulatedMemory shared;
+    shared.store64(0, 1);
+    shared.store64(8, 2);
+
+    SimulatedMemory overlay(&shared);
+    EXPECT_EQ(overlay.load64(8), 2u);
+    EXPECT_EQ(overlay.pageCount(), 0u);
+
+    overlay.store64(0, 10);
+    overlay.store64(0x10000, 20);
+    EXPECT_EQ(overlay.load64(0), 10u);
+    EXPECT_EQ(overlay.load64(8), 2u);  // Copied with the page
+    EXPECT_EQ(shared.load64(0), 1u);   // Not visible until committed
+
+    // Only written words are published, so a concurrent change to word 8 survives
+    shared.store64(8, 3);
+    overlay.commitTo(shared);
+    EXPECT_EQ(shared.load64(0), 10u);
+    EXPECT_EQ(shared.load64(8), 3u);
+    EXPECT_EQ(shared.load64(0x10000), 20u);
+    EXPECT_EQ(overlay.pageCount(), 0u);
+    EXPECT_EQ(overlay.load64(8), 3u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
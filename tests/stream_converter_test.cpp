@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "../src/processor_simulator.hpp"
+#include "../src/stream_converter.hpp"
+
+namespace {
+
+std::string randomBinary(std::mt19937& rng, size_t length) {
+    std::string binary(length, '0');
+    for (char& c : binary) {
+        c = (rng() & 1) ? '1' : '0';
+    }
+    return binary;
+}
+
+// Push `input` in random-sized pieces and collect the output
+std::string streamInPieces(const std::string& input, std::mt19937& rng, size_t blockSize, bool declareTotal) {
+    std::string output;
+    size_t flushes = 0;
+    StreamingHexConverter converter([&](const char* data, size_t length) {
+        EXPECT_LE(length, blockSize);
+        output.append(data, length);
+        ++flushes;
+    }, blockSize);
+    if (declareTotal) {
+        converter.setTotalBits(input.length());
+    }
+    size_t pos = 0;
+    while (pos < input.length()) {
+        size_t piece = std::min<size_t>(rng() % 23, input.length() - pos);
+        converter.push(std::string_view(input).substr(pos, piece));
+        pos += piece;
+    }
+    converter.finish();
+    EXPECT_EQ(converter.digitsWritten(), output.length());
+    return output;
+}
+
+// A body delivered as `pieces`; an incomplete one is cut off after them,
+// as when a chunked upload is dropped
+BodyReader bodyOf(std::vector<std::string> pieces, bool complete) {
+    return [pieces, complete](const BodyReceiver& receiver) {
+        for (const std::string& piece : pieces) {
+            if (!receiver(piece.data(), piece.size())) {
+                return false;
+            }
+        }
+        return complete;
+    };
+}
+
+} // namespace
+
+TEST(StreamingHexConverterTest, MatchesBinaryToHexWhenLengthIsDeclared) {
+    std::mt19937 rng(5);
+    for (size_t length = 0; length < 400; length += 7) {
+        std::string input = randomBinary(rng, length);
+        EXPECT_EQ(streamInPieces(input, rng, 5, true), ProcessorSimulator::binaryToHex(input))
+            << "length " << length;
+    }
+}
+
+TEST(StreamingHexConverterTest, GroupsFromStartWhenLengthIsUnknown) {
+    std::mt19937 rng(9);
+    std::string aligned = randomBinary(rng, 256);
+    EXPECT_EQ(streamInPieces(aligned, rng, 16, false), ProcessorSimulator::binaryToHex(aligned));
+
+    // The trailing partial group becomes a digit of its own
+    EXPECT_EQ(streamInPieces("101011", rng, 16, false), "A3");
+}
+
+TEST(StreamingHexConverterTest, WritesToOstreamAndSkipsWhitespace) {
+    std::ostringstream out;
+    StreamingHexConverter converter(out);
+    converter.setIgnoreWhitespace(true);
+    converter.push("1010 11\n");
+    converter.push("11\r\n0000\t0001\n");
+    converter.finish();
+    EXPECT_EQ(out.str(), "AF01");
+    EXPECT_EQ(converter.bitsConsumed(), 16u);
+}
+
+TEST(StreamingHexConverterTest, RejectsInvalidInput) {
+    std::ostringstream out;
+    StreamingHexConverter converter(out);
+    converter.push("1010");
+    EXPECT_THROW(converter.push("10 1"), ProcessorSimulatorException);
+    EXPECT_THROW(converter.push("1"), ProcessorSimulatorException);
+}
+
+TEST(StreamingHexConverterTest, RejectsShortDeclaredStream) {
+    std::ostringstream out;
+    StreamingHexConverter converter(out);
+    converter.setTotalBits(12);
+    converter.push("10101");
+    EXPECT_THROW(converter.finish(), ProcessorSimulatorException);
+}
+
+TEST(ConvertStreamTest, ConvertsACompleteBody) {
+    std::ostringstream out;
+    StreamingHexConverter converter(out);
+    StreamOutcome outcome = convertStream(converter, bodyOf({"10", "1011", "11"}, true), 1000);
+    EXPECT_TRUE(outcome.error.empty());
+    EXPECT_EQ(out.str(), "AF");
+}
+
+TEST(ConvertStreamTest, RejectsAnAbortedChunkedUpload) {
+    // No declared total, so only the reader knows the body was cut off
+    std::ostringstream out;
+    StreamingHexConverter converter(out);
+    StreamOutcome outcome = convertStream(converter, bodyOf({"1010", "11"}, false), 1000);
+    EXPECT_EQ(outcome.error, "Request body ended early");
+    EXPECT_FALSE(outcome.tooLarge);
+}
+
+TEST(ConvertStreamTest, StopsAtInvalidOrOversizedInput) {
+    std::ostringstream out;
+    StreamingHexConverter invalid(out);
+    StreamOutcome outcome = convertStream(invalid, bodyOf({"1010", "1210", "11"}, true), 1000);
+    EXPECT_NE(outcome.error.find("Invalid binary input"), std::string::npos);
+    EXPECT_EQ(invalid.bitsConsumed(), 8u);  // The last piece is never read
+
+    StreamingHexConverter large(out);
+    outcome = convertStream(large, bodyOf({"1010", "1010", "1010"}, true), 10);
+    EXPECT_TRUE(outcome.tooLarge);
+    EXPECT_EQ(large.bitsConsumed(), 8u);
+
+    // A sink that can no longer deliver stops the stream
+    StreamingHexConverter closed([](const char*, size_t) {
+        throw ProcessorSimulatorException("Client stopped reading the response");
+    }, 1);
+    outcome = convertStream(closed, bodyOf({"1010", "1010"}, true), 1000);
+    EXPECT_EQ(outcome.error, "Client stopped reading the response");
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../src/processor_simulator.hpp"
+#include "../src/thread_pool.hpp"
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(10007);
+    pool.parallelFor(visits.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            visits[i].fetch_add(1);
+        }
+    });
+    for (const auto& count : visits) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTest, SmallWorkRunsInline) {
+    ThreadPool pool(4);
+    std::thread::id caller = std::this_thread::get_id();
+    pool.parallelFor(100, 1000, [&](size_t begin, size_t end) {
+        EXPECT_EQ(begin, 0u);
+        EXPECT_EQ(end, 100u);
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+    });
+}
+
+TEST(ThreadPoolTest, ParallelismOfOneRunsInline) {
+    ThreadPool pool(4);
+    std::thread::id caller = std::this_thread::get_id();
+    pool.parallelFor(1 << 20, 1, [&](size_t, size_t) {
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+    }, 1);
+}
+
+TEST(ThreadPoolTest, PropagatesExceptions) {
+    ThreadPool pool(2);
+    EXPECT_THROW(
+        pool.parallelFor(1000, 1, [](size_t begin, size_t end) {
+            if (begin <= 500 && 500 < end) throw std::runtime_error("boom");
+        }),
+        std::runtime_error);
+}
+
+TEST(ThreadPoolTest, NestedParallelForCompletes) {
+    ThreadPool pool(2);
+    std::atomic<size_t> total{0};
+    pool.parallelFor(8, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            pool.parallelFor(100, 10, [&](size_t b, size_t e) { total.fetch_add(e - b); });
+        }
+    });
+    EXPECT_EQ(total.load(), 800u);
+}
+
+TEST(ThreadPoolTest, SubmittedTasksRun) {
+    std::atomic<int> done{0};
+    {
+        ThreadPool pool(3);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&done]() { done.fetch_add(1); });
+        }
+    }
+    EXPECT_EQ(done.load(), 100);
+}
+
+TEST(ThreadPoolTest, MultiThreadedConversionIsNibbleAligned) {
+    ThreadPool pool(3);
+    ProcessorSimulator simulator(pool);
+    std::mt19937 rng(11);
+    for (size_t length : {ProcessorSimulator::kMinParallelBits * 3 + 1,
+                          ProcessorSimulator::kMinParallelBits * 5 + 2,
+                          ProcessorSimulator::kMinParallelBits * 8 + 3}) {
+        std::string binary(length, '0');
+        for (char& c : binary) c = (rng() & 1) ? '1' : '0';
+        EXPECT_EQ(simulator.multiThreadedBinaryToHex(binary), ProcessorSimulator::binaryToHex(binary));
+
+        simulator.setParallelism(2);
+        EXPECT_EQ(simulator.multiThreadedBinaryToHex(binary, ConversionMode::UNSIGNED),
+                  ProcessorSimulator::binaryToHex(binary));
+        simulator.setParallelism(0);
+
+        binary[length / 2] = '2';
+        EXPECT_THROW(simulator.multiThreadedBinaryToHex(binary), ProcessorSimulatorException);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
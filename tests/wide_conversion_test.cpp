@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "../src/processor_simulator.hpp"
+
+namespace {
+
+std::string convertSigned(const std::string& bits) {
+    return ProcessorSimulator::binaryToHex(bits, ConversionMode::SIGNED);
+}
+
+} // namespace
+
+TEST(WideConversionTest, SignedValuesOfAnyWidth) {
+    EXPECT_EQ(convertSigned("101"), "FFFFFFFD");       // -3
+    EXPECT_EQ(convertSigned("011"), "3");
+    EXPECT_EQ(convertSigned("1"), "FFFFFFFF");         // -1
+    EXPECT_EQ(convertSigned("000"), "0");
+    EXPECT_EQ(convertSigned(""), "");
+    EXPECT_EQ(convertSigned("100000000000"), "FFFFF800");  // -2048
+    EXPECT_EQ(convertSigned("1" + std::string(40, '0')), "FFFFFF0000000000");
+}
+
+TEST(WideConversionTest, SignedBeyondSixtyFourBits) {
+    // 128-bit -1 and the 128-bit minimum
+    EXPECT_EQ(convertSigned(std::string(128, '1')), std::string(32, 'F'));
+    EXPECT_EQ(convertSigned("1" + std::string(127, '0')), "8" + std::string(31, '0'));
+
+    // 65-bit negative values sign-extend to 96 bits
+    EXPECT_EQ(convertSigned("1" + std::string(64, '0')), "FFFFFFFF" + std::string(16, '0'));
+
+    // Large positive values drop their leading zeros
+    EXPECT_EQ(convertSigned(std::string(100, '0') + "1010"), "A");
+    EXPECT_EQ(convertSigned("0" + std::string(199, '1')), "7" + std::string(49, 'F'));
+}
+
+TEST(WideConversionTest, SignedRejectsInvalidInput) {
+    EXPECT_THROW(convertSigned("2" + std::string(100, '0')), ProcessorSimulatorException);
+    EXPECT_THROW(convertSigned("1" + std::string(100, '0') + "x"), ProcessorSimulatorException);
+    EXPECT_THROW(convertSigned(std::string(99, '0') + "x1"), ProcessorSimulatorException);
+}
+
+TEST(WideConversionTest, MultiThreadedSignedMatchesSingleThreaded) {
+    ProcessorSimulator simulator;
+    std::string negative = "1" + std::string(ProcessorSimulator::kMinParallelBits * 3 + 5, '0') + "1";
+    std::string positive = "0001" + std::string(ProcessorSimulator::kMinParallelBits * 2, '1');
+    EXPECT_EQ(simulator.multiThreadedBinaryToHex(negative, ConversionMode::SIGNED), convertSigned(negative));
+    EXPECT_EQ(simulator.multiThreadedBinaryToHex(positive, ConversionMode::SIGNED), convertSigned(positive));
+}
+
+TEST(WideConversionTest, FloatingPointWidths) {
+    // Narrow inputs are zero-extended to binary32
+    EXPECT_EQ(ProcessorSimulator::binaryToHex("1", ConversionMode::FLOATING_POINT), "1.401298E-45");
+    EXPECT_EQ(ProcessorSimulator::binaryToHex("0100000100100000000000000000000", ConversionMode::FLOATING_POINT),
+              "2.439455E-19");
+    EXPECT_THROW(ProcessorSimulator::binaryToHex(std::string(48, '0'), ConversionMode::FLOATING_POINT),
+                 ProcessorSimulatorException);
+    EXPECT_THROW(ProcessorSimulator::binaryToHex(std::string(128, '0'), ConversionMode::FLOATING_POINT),
+                 ProcessorSimulatorException);
+    EXPECT_THROW(ProcessorSimulator::binaryToHex("0120", ConversionMode::FLOATING_POINT),
+                 ProcessorSimulatorException);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}